@@ -31,7 +31,12 @@
  *   assert module; this will change in a future release to be able to
  *   use them independently)
  * - #SCC_NOMOCKS for the mocks module
+ * - #SCC_NOFUZZ for the fuzz module
  */
+#ifndef SCC_NOFUZZ
+#include "sccroll/fuzz.h"
+#endif // SCC_NOFUZZ
+
 #ifndef SCC_NOASSERT
 #include "sccroll/assert.h"
 
@@ -67,14 +67,20 @@ extern void __gcov_dump(void);
 /**
  * @def SCCASSERTFMT
  * @since 0.1.0
- * @brief Assertions message format.
+ * @brief Assertions default message, printed after their location.
  * @see sccroll_assert()
+ */
+#define SCCASSERTFMT "Assertion failed."
+
+/**
+ * @def SCCLOCATIONFMT
+ * @since 0.1.0
+ * @brief Assertions location format, prefixing their message.
  * @param s The file name.
  * @param i The line number.
- * @param s The function name.
  * @param s The tested expression.
  */
-#define SCCASSERTFMT "%s (l. %i): Assertion `%s' failed."
+#define SCCLOCATIONFMT "%s (l. %i): `%s': "
 
 // clang-format off
 
@@ -161,6 +167,142 @@ void sccroll_fatal(int sigint, const char* restrict fmt, ...)
 // clang-format off
 
 /******************************************************************************
+ * @}
+ * @name Results channel
+ *
+ * @brief The assertions failures and the metrics of a test are sent
+ * to the tests runner as binary records, apart from the test standard
+ * outputs.
+ *
+ * The records of a forked test are written in the channel set by the
+ * runner as soon as they are made, and its assertions counts are sent
+ * once the test wrapper returns, or by a failed assertion before
+ * raising #SIGABRT. Out of a channel (tests not forked, or code not
+ * run by a test), the records are kept until sccroll_channelFlush(),
+ * and the failed assertions print their location and message on
+ * stderr.
+ *
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @struct SccrollLocation
+ * @since 0.1.0
+ * @brief Source location of an assertion.
+ */
+typedef struct SccrollLocation {
+    const char* file; /**< The source file name. */
+    int line;         /**< The source line number. */
+    const char* expr; /**< The checked expression. */
+} SccrollLocation;
+
+/**
+ * @def sccroll_here
+ * @since 0.1.0
+ * @brief Give a pointer to the location of the current line.
+ * @param expr The checked expression, as a string.
+ */
+#define sccroll_here(expr) (&(const SccrollLocation){ __FILE__, __LINE__, expr })
+
+/**
+ * @enum SccrollRecordType
+ * @since 0.1.0
+ * @brief Types of the records sent by a test.
+ */
+typedef enum SccrollRecordType {
+    RECORDEND,    /**< End of the records. */
+    RECORDCOUNT,  /**< Number of checked assertions, in SccrollRecord::value. */
+    RECORDFAILED, /**< Number of failed soft assertions, in SccrollRecord::value. */
+    RECORDASSERT, /**< A failed assertion. */
+    RECORDEXPECT, /**< A failed soft assertion. */
+    RECORDMETRIC, /**< A metric, named by SccrollRecord::where expression. */
+    RECORDSIGNAL, /**< A fatal signal, in SccrollRecord::value, with its backtrace. */
+} SccrollRecordType;
+
+/**
+ * @struct SccrollRecord
+ * @since 0.1.0
+ * @brief A record sent by a test.
+ */
+typedef struct SccrollRecord {
+    SccrollRecordType type; /**< The record type. */
+    SccrollLocation where;  /**< The assertion location, or the metric name. */
+    double value;           /**< The count or metric value. */
+    const char* text;       /**< The assertion message. */
+} SccrollRecord;
+
+/**
+ * @def SCCRECORDSMAX
+ * @since 0.1.0
+ * @brief Max byte size of the records kept out of a channel; the soft
+ * assertions failures and metrics which do not fit in are counted,
+ * but not sent.
+ */
+#define SCCRECORDSMAX (2 * BUFSIZ)
+
+/**
+ * @since 0.1.0
+ * @brief Set the channel of the current test records.
+ * @param fd The channel file descriptor, or @c -1 to unset it.
+ */
+void sccroll_channel(int fd);
+
+/**
+ * @since 0.1.0
+ * @brief Send the pending records and the number of checked
+ * assertions in a single write, and forget the records.
+ * @param fd The file descriptor to write in.
+ * @return The write() return value.
+ */
+int sccroll_channelFlush(int fd);
+
+/**
+ * @since 0.1.0
+ * @brief Send the records and a #RECORDSIGNAL record through the
+ * channel, then raise the signal again.
+ *
+ * This signal handler is installed by the tests runner in the forked
+ * tests, on an alternate stack, for the signals of a crash (@c
+ * SIGSEGV, @c SIGBUS, @c SIGFPE, @c SIGILL). The signal record gives
+ * the signal code and faulting address, and the backtrace of the
+ * crash, each frame with its module and offset for addr2line.
+ *
+ * @param sigint The signal.
+ * @param info The signal information.
+ * @param context Unused.
+ */
+void sccroll_channelCrash(int sigint, siginfo_t* info, void* context);
+
+/**
+ * @since 0.1.0
+ * @brief Parse a record sent by a test.
+ * @param buffer The received bytes, with the strings of @p record
+ * pointing into them.
+ * @param size The number of bytes of @p buffer.
+ * @param record The parsed record.
+ * @return The number of bytes of the parsed record, or @c 0 once
+ * there is no more valid record.
+ */
+size_t sccroll_recordRead(const char* restrict buffer, size_t size, SccrollRecord* restrict record)
+    __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Record a custom metric of the current test.
+ *
+ * The metrics are reported by the tests runner, and do not change
+ * the test outcome.
+ *
+ * @param name The metric name.
+ * @param value The metric value.
+ */
+void sccroll_metric(const char* restrict name, double value) __attribute__((nonnull));
+
+// clang-format off
+
+/******************************************************************************
+ * @}
  * @name Assertions with custom error messages
  *
  * These macros and funtions raise an assertion error but do generate
@@ -174,18 +316,62 @@ void sccroll_fatal(int sigint, const char* restrict fmt, ...)
  ******************************************************************************/
 // clang-format on
 
+/**
+ * @var sccroll_asserts
+ * @since 0.1.0
+ * @brief Number of assertions checked by the current test, soft ones
+ * included.
+ *
+ * The count is reported to the tests runner at the end of each test
+ * (see #ASSERTS).
+ *
+ * @note The counter is not atomic: the assertions checked
+ * concurrently by several threads of a test may be miscounted.
+ */
+extern unsigned long sccroll_asserts;
+
 /**
  * @since 0.1.0
  */
 void sccroll_assert(int expr, const char* restrict fmt, ...)
     __attribute__((nonnull (2), format(printf,2,3)));
 
+/**
+ * @since 0.1.0
+ * @brief Failure path of the assertions macros.
+ * @param where The assertion location.
+ * @param fmt The message format string.
+ * @param ... The format string parameters.
+ * @throw #SIGABRT
+ */
+void sccroll_assertFailed(const SccrollLocation* restrict where, const char* restrict fmt, ...)
+    __attribute__((noreturn, cold, nonnull (1, 2), format(printf,2,3)));
+
+/**
+ * @def sccroll_check
+ * @since 0.1.0
+ * @brief Count an assertion and check it inline.
+ *
+ * A passing assertion costs a counter increment and a single branch,
+ * predicted as taken; the failure path is a cold out-of-line call.
+ *
+ * @param failure The function called with the location of @p expr
+ * and the remaining arguments if @p expr is @c false.
+ * @param expr The checked expression.
+ * @param string The checked expression as written by the caller,
+ * before its macros expansion.
+ * @param ... The @p failure arguments.
+ */
+#define sccroll_check(failure, expr, string, ...)             \
+    ((void)++sccroll_asserts,                                 \
+        __builtin_expect(!!(expr), 1) ? (void)0 : failure(sccroll_here(string), __VA_ARGS__))
+
 /**
  * @def assertMsg
  * @since 0.1.0
- * @brief Macro alias of sccroll_assert().
+ * @brief Inline counterpart of sccroll_assert().
  */
-#define assertMsg sccroll_assert
+#define assertMsg(expr, ...) sccroll_check(sccroll_assertFailed, expr, #expr, __VA_ARGS__)
 
 // clang-format off
 
@@ -214,9 +400,7 @@ void sccroll_assert(int expr, const char* restrict fmt, ...)
      * and #NDEBUG is not defined.
      * @param expr Boolean expression that raise an assertion error if @c false.
      */
-    #define assert(expr)             \
-        sccroll_assert((bool)(expr), \
-            SCCASSERTFMT, __FILE__, __LINE__, #expr)
+    #define assert(expr) sccroll_check(sccroll_assertFailed, expr, #expr, SCCASSERTFMT)
 #endif // _ASSERT_H
 
 /**
@@ -339,6 +523,300 @@ void sccroll_assert(int expr, const char* restrict fmt, ...)
  */
 #define assertGreaterOrEqual(a, b, cmp, ...) assertCmp(a, >=, b, cmp, ##__VA_ARGS__)
 
+// clang-format off
+
+/******************************************************************************
+ * @}
+ * @name Assertions on arrays
+ *
+ * @brief These macros and functions raise an assertion error if two
+ * arrays differ.
+ *
+ * The arrays are compared in vectorized chunks. On failure, the
+ * message gives the number of differing elements, the index of the
+ * first one, and a dump of the elements around it.
+ *
+ * @{
+ * @param a,b The arrays to compare.
+ * @param nmemb The number of elements of the arrays.
+ * @param size The byte size of the blobs to compare.
+ * @param tolerance The maximal absolute difference of two elements.
+ * @throw #SIGABRT if the arrays differ.
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @enum SccrollArrayType
+ * @since 0.1.0
+ * @brief Arrays elements types, used to print them.
+ */
+typedef enum SccrollArrayType {
+    SCCARRAYBYTES,   /**< Opaque elements, printed as bytes. */
+    SCCARRAYINT,     /**< Signed integers. */
+    SCCARRAYUINT,    /**< Unsigned integers. */
+    SCCARRAYFLOAT,   /**< @c float numbers. */
+    SCCARRAYDOUBLE,  /**< @c double numbers. */
+    SCCARRAYLDOUBLE, /**< <tt>long double</tt> numbers. */
+} SccrollArrayType;
+
+/**
+ * @struct SccrollArray
+ * @since 0.1.0
+ * @brief Arrays comparison parameters.
+ */
+typedef struct SccrollArray {
+    const void* a;         /**< The first array. */
+    const void* b;         /**< The second array. */
+    size_t nmemb;          /**< The number of elements of the arrays. */
+    size_t size;           /**< The byte size of an element. */
+    SccrollArrayType type; /**< The type of the elements. */
+    double tolerance;      /**< The tolerance for the floating point types, or a negative value for an exact comparison. */
+} SccrollArray;
+
+/**
+ * @def sccroll_arrayType
+ * @since 0.1.0
+ * @brief Give the SccrollArrayType of an expression.
+ * @param x The expression.
+ */
+#define sccroll_arrayType(x)                                         \
+    _Generic((x),                                                    \
+        char: SCCARRAYINT, signed char: SCCARRAYINT,                 \
+        short: SCCARRAYINT, int: SCCARRAYINT,                        \
+        long: SCCARRAYINT, long long: SCCARRAYINT,                   \
+        unsigned char: SCCARRAYUINT, unsigned short: SCCARRAYUINT,   \
+        unsigned int: SCCARRAYUINT, unsigned long: SCCARRAYUINT,     \
+        unsigned long long: SCCARRAYUINT,                            \
+        float: SCCARRAYFLOAT, double: SCCARRAYDOUBLE,                \
+        long double: SCCARRAYLDOUBLE,                                \
+        default: SCCARRAYBYTES)
+
+/**
+ * @def sccroll_arrayFloat
+ * @since 0.1.0
+ * @brief Give the SccrollArrayType of a floating point expression.
+ *
+ * Any other type of expression is a compilation error.
+ *
+ * @param x The expression.
+ */
+#define sccroll_arrayFloat(x)                                        \
+    _Generic((x),                                                    \
+        float: SCCARRAYFLOAT, double: SCCARRAYDOUBLE,                \
+        long double: SCCARRAYLDOUBLE)
+
+/**
+ * @since 0.1.0
+ * @brief Raise an assertion error if two arrays differ.
+ *
+ * The elements are compared bitwise if SccrollArray::tolerance is
+ * negative: a @c NaN equals itself, and @c -0.0 differs from @c 0.0.
+ * Otherwise, the elements must be @c float, @c double or
+ * <tt>long double</tt>, and @c NaN is never near anything.
+ *
+ * @param array The comparison parameters.
+ * @param where The assertion location.
+ * @param fmt The assertion message format string.
+ * @param ... The format string parameters.
+ */
+void sccroll_assertArray(const SccrollArray* restrict array, const SccrollLocation* restrict where, const char* restrict fmt, ...)
+    __attribute__((nonnull (1, 2, 3), format(printf,3,4)));
+
+/**
+ * @def assertArrayEqual
+ * @since 0.1.0
+ * @brief Assert that the @p nmemb first elements of @p a and @p b
+ * are the same.
+ */
+#define assertArrayEqual(a, b, nmemb)                                    \
+    sccroll_assertArray(                                                 \
+        &(SccrollArray){ (a), (b), (nmemb), sizeof(*(a)),                \
+            sccroll_arrayType(*(a)), -1 },                               \
+        sccroll_here(#a " == " #b), SCCASSERTFMT)
+
+/**
+ * @def assertMemEqual
+ * @since 0.1.0
+ * @brief Assert that the @p size first bytes of @p a and @p b are
+ * the same.
+ */
+#define assertMemEqual(a, b, size)                                       \
+    sccroll_assertArray(                                                 \
+        &(SccrollArray){ (a), (b), (size), 1, SCCARRAYBYTES, -1 },      \
+        sccroll_here(#a " == " #b), SCCASSERTFMT)
+
+/**
+ * @def assertFloatsNear
+ * @since 0.1.0
+ * @brief Assert that the @p nmemb first elements of the floating
+ * point arrays @p a and @p b differ by at most @p tolerance.
+ */
+#define assertFloatsNear(a, b, nmemb, tolerance)                         \
+    sccroll_assertArray(                                                 \
+        &(SccrollArray){ (a), (b), (nmemb), sizeof(*(a)),                \
+            sccroll_arrayFloat(*(a)), (tolerance) },                     \
+        sccroll_here(#a " ~= " #b), SCCASSERTFMT)
+
+// clang-format off
+
+/******************************************************************************
+ * @}
+ * @name Soft assertions
+ *
+ * @brief These macros and functions are the counterparts of the
+ * assertions above, but do not stop the test on failure.
+ *
+ * The failures are recorded with their file and line, and the test
+ * goes on. Once the test wrapper returns, the test fails if any
+ * expectation failed, and all the recorded failures are reported.
+ *
+ * @attention The failures recorded by a test which does not return
+ * from its wrapper (crash, exit()...) are lost, unless it stops on a
+ * failed assertion.
+ *
+ * @{
+ * @param expr Boolean expression that records a failure if @c false.
+ * @param fmt The message format string.
+ * @param ... The format string parameters, or additional optional
+ * arguments for the @p cmp function.
+ * @param a,b The variables, values or pointers to compare.
+ * @param sign Either @c <, @c > or @c ==.
+ * @param cmp Comparison function taking @p a and @p b as parameters
+ * and returning an integer, similar to the qsort() compare functions.
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @def SCCEXPECTFMT
+ * @since 0.1.0
+ * @brief Soft assertions default message, printed after their
+ * location.
+ * @see sccroll_expect()
+ */
+#define SCCEXPECTFMT "Expectation failed."
+
+/**
+ * @since 0.1.0
+ * @brief Record a failure message if @p expr is @c false.
+ */
+void sccroll_expect(int expr, const char* restrict fmt, ...)
+    __attribute__((nonnull (2), format(printf,2,3)));
+
+/**
+ * @since 0.1.0
+ * @brief Failure path of the soft assertions macros.
+ * @param where The assertion location.
+ * @param fmt The message format string.
+ * @param ... The format string parameters.
+ */
+void sccroll_expectFailed(const SccrollLocation* restrict where, const char* restrict fmt, ...)
+    __attribute__((cold, nonnull (1, 2), format(printf,2,3)));
+
+/**
+ * @def expectMsg
+ * @since 0.1.0
+ * @brief Inline counterpart of sccroll_expect().
+ */
+#define expectMsg(expr, ...) sccroll_check(sccroll_expectFailed, expr, #expr, __VA_ARGS__)
+
+/**
+ * @def expect
+ * @since 0.1.0
+ * @brief Soft assertion counterpart of assert().
+ */
+#define expect(expr) sccroll_check(sccroll_expectFailed, expr, #expr, SCCEXPECTFMT)
+
+/**
+ * @def expectTrue
+ * @since 0.1.0
+ * @brief Alias of expect().
+ */
+#define expectTrue expect
+
+/**
+ * @def expectFalse
+ * @since 0.1.0
+ * @brief Expect that the expression is @c false.
+ */
+#define expectFalse(expr) expectTrue(!(expr))
+
+/**
+ * @def expectNot
+ * @since 0.1.0
+ * @brief Alias of expectFalse().
+ */
+#define expectNot expectFalse
+
+/**
+ * @def expectNull
+ * @since 0.1.0
+ * @brief Alias of expectFalse().
+ */
+#define expectNull expectFalse
+
+/**
+ * @def expectEql
+ * @since 0.1.0
+ * @brief Expect that @code a == b @endcode
+ */
+#define expectEql(a, b) expect(a == b)
+
+/**
+ * @def expectNotEql
+ * @since 0.1.0
+ * @brief Expect that @code a != b @endcode
+ */
+#define expectNotEql(a, b) expect(a != b)
+
+/**
+ * @def expectCmp
+ * @since 0.1.0
+ * @brief Expect the @code a sign b @endcode comparison.
+ */
+#define expectCmp(a, sign, b, cmp, ...) expect(cmp(a, b, ##__VA_ARGS__) sign 0)
+
+/**
+ * @def expectEqual
+ * @since 0.1.0
+ * @brief Expect the @code a == b @endcode comparison.
+ */
+#define expectEqual(a, b, cmp, ...) expectCmp(a, ==, b, cmp, ##__VA_ARGS__)
+
+/**
+ * @def expectNotEqual
+ * @since 0.1.0
+ * @brief Expect the @code a != b @endcode comparison.
+ */
+#define expectNotEqual(a, b, cmp, ...) expectCmp(a, !=, b, cmp, ##__VA_ARGS__)
+
+/**
+ * @def expectSmaller
+ * @since 0.1.0
+ * @brief Expect the @code a < b @endcode comparison.
+ */
+#define expectSmaller(a, b, cmp, ...) expectCmp(a, <, b, cmp, ##__VA_ARGS__)
+
+/**
+ * @def expectGreater
+ * @since 0.1.0
+ * @brief Expect the @code a > b @endcode comparison.
+ */
+#define expectGreater(a, b, cmp, ...) expectCmp(a, >, b, cmp, ##__VA_ARGS__)
+
+/**
+ * @def expectSmallerOrEqual
+ * @since 0.1.0
+ * @brief Expect the @code a <= b @endcode comparison.
+ */
+#define expectSmallerOrEqual(a, b, cmp, ...) expectCmp(a, <=, b, cmp, ##__VA_ARGS__)
+
+/**
+ * @def expectGreaterOrEqual
+ * @since 0.1.0
+ * @brief Expect the @code a >= b @endcode comparison.
+ */
+#define expectGreaterOrEqual(a, b, cmp, ...) expectCmp(a, >=, b, cmp, ##__VA_ARGS__)
+
 // clang-format off
 
 /******************************************************************************
@@ -0,0 +1,72 @@
+/**
+ * @file        clock.h
+ * @version     0.1.0
+ * @brief       Virtual clock switch of the mocks.
+ * @author      Alexandre Martos
+ * @email       contact@amartos.fr
+ * @copyright   2022-2023 Alexandre Martos <contact@amartos.fr>
+ * @license     MIT License
+ *
+ * This header is kept apart from the mocks overrides, as the core
+ * module switches the virtual clock off after each test without
+ * including them.
+ *
+ * @addtogroup API
+ * @{
+ * @addtogroup MocksAPI
+ * @{
+ */
+
+#ifndef SCCROLL_CLOCK_H_
+#define SCCROLL_CLOCK_H_
+
+#include <stdbool.h>
+
+// clang-format off
+
+/******************************************************************************
+ * @name Virtual clock
+ *
+ * The time functions of the C library are mocked by a virtual clock,
+ * which only moves when told to: the sleeps and the timeouts of
+ * poll() and select() return at once, advancing the clock by their
+ * duration. The timeouts logic of a test is thus checked in
+ * microseconds, whatever the durations involved.
+ *
+ * The virtual clocks start from the real time at which the virtual
+ * clock is switched on; the CPU time clocks are never virtual. A
+ * poll() or select() with no timeout still waits for real. The clock
+ * is switched back to the real time at the end of each test.
+ *
+ * These mocks are not predefined mocks: they cannot be triggered.
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @since 0.1.0
+ * @brief Switch the virtual clock on or off.
+ *
+ * Switching on a clock already virtual does not change its time.
+ *
+ * @param enabled @c true for the virtual clock, @c false for the real
+ * one.
+ */
+void sccroll_mockClock(bool enabled);
+
+/**
+ * @since 0.1.0
+ * @brief Advance the virtual clock.
+ * @param nsec The number of nanoseconds to advance the clock of;
+ * ignored if the clock is real.
+ */
+void sccroll_mockAdvance(unsigned long long nsec);
+
+// clang-format off
+/******************************************************************************
+ * @}
+ ******************************************************************************/
+// clang-format on
+
+#endif // SCCROLL_CLOCK_H_
+/** @} @} */
@@ -47,16 +47,31 @@
 #include <argz.h>
 #include <err.h>
 #include <errno.h>
+#include <execinfo.h>
 #include <ctype.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <inttypes.h>
 #include <libgen.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <linux/mempolicy.h>
+
 // clang-format off
 
 /******************************************************************************
@@ -139,11 +154,54 @@ typedef enum SccrollIndexes {
  * @attention The default for each test is "not any options".
  */
 typedef enum SccrollFlags {
-    NOSTRP = 1, /**< Do not strip left and right standard outputs. */
-    NOFORK = 2, /**< Do not fork before executing the test. */
-    NODIFF = 4, /**< Do no print diffs of expected/obtained. */
+    NOSTRP  = 1, /**< Do not strip left and right standard outputs. */
+    NOFORK  = 2, /**< Do not fork before executing the test. */
+    NODIFF  = 4, /**< Do no print diffs of expected/obtained. */
+    ASSERTS = 8, /**< Fail if the test checks no assertion (see #sccroll_asserts). */
 } SccrollFlags;
 
+/**
+ * @def SCCUPDATE
+ * @since 0.1.0
+ * @brief Environment variable enabling the expectations update mode.
+ *
+ * If set to a non-empty value other than @c 0 when sccroll_run() is
+ * called, the on-disk expectations are updated instead of compared.
+ * @see SccrollEffects
+ */
+#define SCCUPDATE "SCCROLL_UPDATE"
+
+/**
+ * @def SCCPROFILE
+ * @since 0.1.0
+ * @brief Environment variable enabling the runner self-profiling.
+ *
+ * If set to a non-empty value other than @c 0 when sccroll_run() is
+ * called, the time spent by the runner in each phase of the tests
+ * executions (pipes setup, fork, standard input writing, test,
+ * wait, outputs capture, files reading, comparisons and reports) is
+ * measured in all the tests processes, and the breakdown is printed
+ * on stderr at the end of the run.
+ */
+#define SCCPROFILE "SCCROLL_PROFILE"
+
+/**
+ * @def SCCTRACE
+ * @since 0.1.0
+ * @brief Environment variable giving the path of a run trace file.
+ *
+ * If set to a non-empty value when sccroll_run() is called, the run
+ * timeline is written in this file using the Trace Event JSON format,
+ * which can be opened in a trace viewer (@c chrome://tracing,
+ * Perfetto). Each test, and each of the phases listed for
+ * #SCCPROFILE, is a span on the lane of the runner or of the suite
+ * worker which ran it. The tests spans give as arguments the test
+ * process id, its status (@c pass, @c fail or @c limit), its code,
+ * its number of checked assertions, its resources usage, and the
+ * location of the failed assertion which stopped it, if any.
+ */
+#define SCCTRACE "SCCROLL_TRACE"
+
 /**
  * @struct SccrollFile
  * @since 0.1.0
@@ -152,6 +210,9 @@ typedef enum SccrollFlags {
 typedef struct SccrollFile {
     const char* path; /**< The file path. */
     Data content;     /**< The file content. */
+    const char* hash; /**< The file content BLAKE3 hexadecimal digest. */
+    const char* ref;  /**< A reference file storing the expected content. */
+    const char* tree; /**< A reference directory storing the expected files. */
 } SccrollFile;
 
 /**
@@ -175,6 +236,27 @@ typedef struct SccrollCode {
     int value;            /**< Valeur attendue. */
 } SccrollCode;
 
+/**
+ * @struct SccrollLimits
+ * @since 0.1.0
+ * @brief Resources limits of a test.
+ *
+ * A @c 0 value leaves the corresponding resource unlimited.
+ */
+typedef struct SccrollLimits {
+    rlim_t memory; /**< Max memory, in bytes. */
+    rlim_t cpu;    /**< Max CPU time, in seconds. */
+    rlim_t files;  /**< Max number of file descriptors, standard ones included. */
+    rlim_t output; /**< Max size of the written files, in bytes. */
+} SccrollLimits;
+
+/**
+ * @def SCCCGROUP
+ * @since 0.1.0
+ * @brief Mount point of the cgroup v2 hierarchy.
+ */
+#define SCCCGROUP "/sys/fs/cgroup"
+
 /**
  * @struct SccrollEffects
  * @since 0.1.0
@@ -240,6 +322,71 @@ typedef struct SccrollCode {
  * characters), indicate a content size in
  * SccrollEffects::files::size.
  *
+ * Large files can instead be declared by the digest of their content
+ * (see sccroll_hash()) in SccrollEffects::files::hash, and optionally
+ * their byte size in SccrollEffects::files::content::size. The
+ * expected content is then never loaded, and the obtained file is
+ * hashed in a single streaming pass, whatever its size. On a
+ * mismatch, the digests are reported, unless a reference file
+ * storing the expected content is given in
+ * SccrollEffects::files::ref, in which case the first #SCCMAX bytes
+ * of both files are diffed as strings.
+ *
+ * A whole directory can be checked at once by giving a reference
+ * directory in SccrollEffects::files::tree: the regular files of
+ * both SccrollEffects::files::path and the reference trees are then
+ * compared in parallel, and the files missing, extra, or with a
+ * different content in the obtained tree are reported. The sizes are
+ * checked first, then the digests of the contents; only the
+ * mismatching files are read again to find their first different
+ * byte. Empty directories, links and special files are ignored.
+ *
+ * ## Expectations update
+ *
+ * When the #SCCUPDATE environment variable is set, the expectations
+ * read from disk are rewritten with the obtained effects instead of
+ * being compared: the SccrollEffects::std::path of the standard
+ * outputs, the SccrollEffects::files::ref reference files of the
+ * hashed files, and the SccrollEffects::files::tree reference trees
+ * (whose files are then created, replaced or removed, in parallel).
+ * Each file is replaced atomically, and reported on stderr. The new
+ * digests of the hashed files are reported too, as they are given
+ * inline. The other expectations are still compared.
+ *
+ * ## Fixtures
+ *
+ * A test can be run upon the state built by a registered
+ * SccrollFixture, by giving its name in SccrollEffects::fixture (see
+ * sccroll_fixture()).
+ *
+ * ## Suites
+ *
+ * A test can be grouped with others in a SccrollSuite, by giving its
+ * name in SccrollEffects::suite (see sccroll_suite()).
+ *
+ * ## Resources limits
+ *
+ * The resources used by a forked test are bounded by the
+ * SccrollEffects::limits, applied with setrlimit() in the test
+ * process. The SccrollLimits::memory bounds the address space of
+ * the test; if the cgroup v2 hierarchy is mounted at #SCCCGROUP and
+ * the cgroup of the tests runner is writable, the runner moves to
+ * its own leaf of this cgroup, which then delegates the memory
+ * controller: the test is also run in a dedicated child cgroup whose
+ * @c memory.max is set to this value. Unless it is the root cgroup,
+ * the runner must be alone in its cgroup (e.g. started with
+ * @c systemd-run @c --user @c --scope), and its leaf is left for the
+ * cgroup manager to remove once the runner exits.
+ *
+ * A test exceeding its CPU time or written files size, or killed by
+ * the cgroup out of memory handler, fails with a distinct report,
+ * unless the corresponding signal is its expected
+ * SccrollEffects::code. The other limits make the corresponding
+ * calls fail (see setrlimit()), which the test may check.
+ *
+ * @attention The limits are not applied to the tests flagged
+ * #NOFORK.
+ *
  * ## Tests options
  *
  * All the available options for the tests are described in the
@@ -254,6 +401,9 @@ typedef struct SccrollEffects {
     SccrollFlags flags;   /**< Options flags for the test. */
     SccrollFunc wrapper;  /**< The test function wrapper pointer. */
     const char* name;     /**< The test name. */
+    const char* fixture;  /**< The name of the SccrollFixture of the test. */
+    const char* suite;    /**< The name of the SccrollSuite of the test. */
+    SccrollLimits limits; /**< Resources limits of the test. */
 } SccrollEffects;
 
 // clang-format off
@@ -333,6 +483,212 @@ void sccroll_register(const SccrollEffects* restrict expected)
     }                                                                          \
     static void testname(void)
 
+// clang-format off
+
+/******************************************************************************
+ * @}
+ *
+ * @name Fixtures
+ *
+ * Fixtures are used to share an expensive initialization between
+ * tests, without redoing it for each test nor sharing it unsafely.
+ *
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @struct SccrollFixture
+ * @since 0.1.0
+ * @brief A named state shared by tests.
+ */
+typedef struct SccrollFixture {
+    const char* name;     /**< The fixture name. */
+    SccrollFunc setup;    /**< The function building the state. */
+    SccrollFunc teardown; /**< The function releasing it (optional). */
+} SccrollFixture;
+
+/**
+ * @since 0.1.0
+ * @brief Registers a fixture.
+ *
+ * The tests whose SccrollEffects::fixture is the SccrollFixture::name
+ * of @p fixture are run by sccroll_run() in a dedicated process,
+ * forked once for all of them. This process calls
+ * SccrollFixture::setup, runs the tests (including the
+ * sccroll_before() and sccroll_after() hooks), then calls
+ * SccrollFixture::teardown. Since each test is itself forked from
+ * this process, it starts from a pristine copy-on-write snapshot of
+ * the state built by the setup, whatever the previous tests did ---
+ * except for the tests flagged #NOFORK, which are run directly in
+ * the fixture process.
+ *
+ * If the fixture process does not end normally, all of its tests
+ * are considered failed.
+ *
+ * @attention The fixtures apply to the tests run by sccroll_run()
+ * only: they are ignored by sccroll_exec().
+ * @param fixture The fixture to register. The structure is copied,
+ * but not the pointed name.
+ * @throw #EXIT_FAILURE if a test gives the name of an unregistered
+ * fixture when run.
+ */
+void sccroll_fixture(const SccrollFixture* restrict fixture)
+    __attribute__((nonnull));
+
+/**
+ * @def SCCROLL_FIXTURE
+ * @since 0.1.0
+ * @brief Define a fixture.
+ *
+ * This macro is used the same way as SCCROLL_TEST(): its first
+ * argument is the SccrollFixture::setup function definition, which
+ * is also used as the fixture name, and the remaining arguments, if
+ * any, are used for the SccrollFixture definition.
+ *
+ * @code
+ * SCCROLL_FIXTURE(dataset, .teardown = unload) { load("dataset.csv"); }
+ * SCCROLL_TEST(test_query, .fixture = "dataset") { assert(query(42)); }
+ * @endcode
+ *
+ * @param fixturename The setup function name also used as the
+ * fixture name.
+ * @param ... The remaining SccrollFixture data.
+ */
+#define SCCROLL_FIXTURE(fixturename, ...)                                        \
+    static void fixturename(void);                                               \
+    __attribute__((constructor)) static void sccroll_fixture_##fixturename(void) \
+    {                                                                            \
+        const SccrollFixture fixture = {                                         \
+            .setup = fixturename,                                                \
+            .name  = #fixturename,                                               \
+            ##__VA_ARGS__                                                        \
+        };                                                                       \
+        sccroll_fixture(&fixture);                                               \
+    }                                                                            \
+    static void fixturename(void)
+
+// clang-format off
+
+/******************************************************************************
+ * @}
+ *
+ * @name Suites
+ *
+ * Suites are used to group tests with their own hooks and scheduling
+ * in a single binary, for example to run CPU-heavy tests in parallel
+ * and resource-contended ones serially.
+ *
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @struct SccrollSuite
+ * @since 0.1.0
+ * @brief A named group of tests.
+ */
+typedef struct SccrollSuite {
+    const char* name;  /**< The suite name. */
+    SccrollFunc init;  /**< Function executed before the suite tests (optional). */
+    SccrollFunc clean; /**< Function executed after the suite tests (optional). */
+    int jobs;          /**< Max number of tests run concurrently. */
+    const char* cpus;  /**< The CPUs list the workers are pinned to (optional). */
+    bool numa;         /**< Bind the workers memory to their CPU NUMA node. */
+} SccrollSuite;
+
+/**
+ * @def SCCSUITES
+ * @since 0.1.0
+ * @brief Environment variable selecting the suites to run.
+ *
+ * If set to a non-empty comma-separated list of suites names when
+ * sccroll_run() is called, only the tests of these suites are run;
+ * the other ones are skipped, and not counted in the report.
+ */
+#define SCCSUITES "SCCROLL_SUITES"
+
+/**
+ * @def SCCWORKERS
+ * @since 0.1.0
+ * @brief Environment variable enabling the suites workers reports.
+ *
+ * If set to a non-empty value other than @c 0 when sccroll_run() is
+ * called, each worker of a parallel suite reports on stderr its CPU,
+ * the number of tests units it ran, and its CPU time over its
+ * lifetime.
+ */
+#define SCCWORKERS "SCCROLL_WORKERS"
+
+/**
+ * @since 0.1.0
+ * @brief Registers a suite.
+ *
+ * The tests whose SccrollEffects::suite is the SccrollSuite::name of
+ * @p suite are run together by sccroll_run(), between the
+ * SccrollSuite::init and SccrollSuite::clean calls, which are
+ * executed only once and in the main process.
+ *
+ * Up to SccrollSuite::jobs tests of the suite are run concurrently,
+ * in as many worker processes; @c 0 or @c 1 runs them serially, and
+ * a negative value as many at once as there are online processors.
+ * The tests of a same fixture (see sccroll_fixture()) are always run
+ * by the same worker. The reports of each test are printed at once
+ * when it ends.
+ *
+ * If SccrollSuite::cpus is given, each worker is pinned to a single
+ * CPU of the list, round-robin. The list uses the cpuset format
+ * (e.g. @c "0-3,8"), and an empty string stands for all the CPUs
+ * the tests runner may use. A negative SccrollSuite::jobs then runs
+ * as many workers as there are CPUs in the list. The memory of the
+ * pinned workers is moreover bound to the NUMA node of their CPU if
+ * SccrollSuite::numa is set, when the system supports it.
+ *
+ * Each worker reports its utilization when done if the #SCCWORKERS
+ * environment variable is set.
+ *
+ * The tests without suite, or whose suite is not registered, are
+ * run serially without suite hooks.
+ *
+ * @param suite The suite to register. The structure is copied, but
+ * not the pointed name.
+ */
+void sccroll_suite(const SccrollSuite* restrict suite)
+    __attribute__((nonnull));
+
+/**
+ * @def SCCROLL_SUITE
+ * @since 0.1.0
+ * @brief Define a suite.
+ *
+ * This macro is used the same way as SCCROLL_TEST(): its first
+ * argument is the SccrollSuite::init function definition, which is
+ * also used as the suite name, and the remaining arguments, if any,
+ * are used for the SccrollSuite definition.
+ *
+ * @code
+ * SCCROLL_SUITE(heavy, .jobs = -1) {}
+ * SCCROLL_SUITE(database, .clean = disconnect) { connect(); }
+ * SCCROLL_TEST(test_compress, .suite = "heavy") { assert(compress()); }
+ * @endcode
+ *
+ * @param suitename The init function name also used as the suite
+ * name.
+ * @param ... The remaining SccrollSuite data.
+ */
+#define SCCROLL_SUITE(suitename, ...)                                          \
+    static void suitename(void);                                               \
+    __attribute__((constructor)) static void sccroll_suite_##suitename(void)   \
+    {                                                                          \
+        const SccrollSuite suite = {                                           \
+            .init = suitename,                                                 \
+            .name = #suitename,                                                \
+            ##__VA_ARGS__                                                      \
+        };                                                                     \
+        sccroll_suite(&suite);                                                 \
+    }                                                                          \
+    static void suitename(void)
+
 // clang-format off
 
 /******************************************************************************
@@ -363,6 +719,41 @@ void sccroll_register(const SccrollEffects* restrict expected)
  */
 int sccroll_run(void);
 
+/**
+ * @since 0.1.0
+ * @brief Execute a test once, without any comparison nor report.
+ *
+ * The test is prepared and executed the same way the registered
+ * tests are, including the fork isolation (unless #NOFORK is set) and
+ * the emulated standard input. This function is used by tools built
+ * upon the library that need the test side effects rather than a
+ * pass/fail status (see the fuzz module).
+ *
+ * The SccrollEffects::std::content of index #STDIN_FILENO is written
+ * as a bytes blob if its Data::size is set, and as a string
+ * otherwise.
+ *
+ * @param effects The test to execute.
+ * @return The code observed after the test execution, of the same
+ * SccrollCodeType as the one of @p effects.
+ */
+SccrollCode sccroll_exec(const SccrollEffects* restrict effects) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Allocate scratch memory for the running test.
+ *
+ * The memory is served by the arena backing the library allocations
+ * of the test (see SccrollArena), and is released at once at the end
+ * of the test: it must not be freed. This is much faster than
+ * malloc() for many small temporary allocations.
+ *
+ * @param size The number of bytes to allocate.
+ * @return A pointer to @p size uninitialized bytes, or @c NULL in
+ * case of errors.
+ */
+void* sccroll_scratch(size_t size) __attribute__((malloc, alloc_size(1)));
+
 // clang-format off
 /******************************************************************************
  * @}
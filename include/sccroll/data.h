@@ -25,6 +25,9 @@
 #endif
 
 #include <err.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -131,6 +134,220 @@ void* sccroll_rndalloc(size_t nmemb, size_t size);
  */
 void* blobdup(const void* restrict blob, size_t size);
 
+// clang-format off
+
+/******************************************************************************
+ * @}
+ * @name Arena allocation.
+ *
+ * An arena serves many small allocations from large chunks, by simply
+ * bumping an offset, and releases them all at once.
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @enum SccrollArenaSizes
+ * @since 0.1.0
+ * @brief Arena constants.
+ */
+typedef enum SccrollArenaSizes {
+    SCCARENACHUNK = 1 << 16,                  /**< Default byte size of an arena chunk. */
+    SCCARENAALIGN = __alignof__(long double), /**< Alignment of the arena allocations. */
+} SccrollArenaSizes;
+
+/**
+ * @struct SccrollChunk
+ * @since 0.1.0
+ * @brief An arena memory chunk.
+ */
+typedef struct SccrollChunk {
+    struct SccrollChunk* next; /**< The previously allocated chunk. */
+    size_t size;               /**< The chunk data byte size. */
+    size_t used;               /**< The number of used bytes. */
+    unsigned char data[] __attribute__((aligned(SCCARENAALIGN))); /**< The chunk data. */
+} SccrollChunk;
+
+/**
+ * @struct SccrollArena
+ * @since 0.1.0
+ * @brief An arena allocator.
+ *
+ * A zeroed structure is an empty arena, ready to use.
+ */
+typedef struct SccrollArena {
+    SccrollChunk* head; /**< The current chunk. */
+} SccrollArena;
+
+/**
+ * @since 0.1.0
+ * @brief Allocate memory in an arena.
+ *
+ * The returned memory is suitably aligned for any type, and valid
+ * until the arena is reset or freed. A new chunk of #SCCARENACHUNK
+ * bytes (or more, for larger sizes) is malloc'ed when the current one
+ * is full.
+ *
+ * @param arena The arena.
+ * @param size The number of bytes to allocate.
+ * @return A pointer to @p size uninitialized bytes, or @c NULL in
+ * case of errors.
+ */
+void* sccroll_arenaAlloc(SccrollArena* restrict arena, size_t size)
+    __attribute__((nonnull, malloc, alloc_size(2)));
+
+/**
+ * @since 0.1.0
+ * @brief Copy a blob in an arena.
+ *
+ * This is the arena counterpart of blobdup(), with an additional null
+ * byte after the copy, to allow strings comparisons.
+ *
+ * @param arena The arena.
+ * @param blob The blob to copy, or @c NULL.
+ * @param size The byte size of @p blob.
+ * @return A pointer to @p size + 1 bytes, or @c NULL in case of
+ * errors.
+ */
+void* sccroll_arenaDup(SccrollArena* restrict arena, const void* restrict blob, size_t size)
+    __attribute__((nonnull(1)));
+
+/**
+ * @since 0.1.0
+ * @brief Release all the allocations of an arena at once.
+ *
+ * The first allocated chunk is kept for the next allocations, and the
+ * others are freed.
+ *
+ * @param arena The arena.
+ */
+void sccroll_arenaReset(SccrollArena* restrict arena) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Free all the chunks of an arena.
+ * @param arena The arena, left empty.
+ */
+void sccroll_arenaFree(SccrollArena* restrict arena) __attribute__((nonnull));
+
+// clang-format off
+
+/******************************************************************************
+ * @}
+ * @name Data comparison.
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @since 0.1.0
+ * @brief Give the length of the leading span of two blobs where the
+ * bytes are all equal, or all different.
+ *
+ * The comparison is vectorized (AVX-512, AVX2 or SSE2, depending on
+ * the CPU at run time), and falls back to a bytes loop otherwise.
+ *
+ * With @p equal set to @c true, the returned value is the offset of
+ * the first mismatch, or @p size if the blobs are the same; with
+ * @p equal set to @c false, it is the length of the mismatch run
+ * starting at the first byte.
+ *
+ * @param a,b The blobs to compare.
+ * @param size The number of bytes to compare.
+ * @param equal Whether to measure a span of equal or different bytes.
+ * @return The span length, at most @p size.
+ */
+size_t blobspan(const void* restrict a, const void* restrict b, size_t size, bool equal)
+    __attribute__((pure, nonnull));
+
+// clang-format off
+
+/******************************************************************************
+ * @}
+ * @name Data hashing.
+ *
+ * Blobs are hashed with BLAKE3 (256 bits digests), in a streaming
+ * fashion: a blob can be given in as many parts as needed.
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @enum SccrollHashSizes
+ * @since 0.1.0
+ * @brief Hashing constants.
+ */
+typedef enum SccrollHashSizes {
+    SCCHASHSIZE  = 32,                  /**< Digest byte size. */
+    SCCHASHHEX   = SCCHASHSIZE * 2 + 1, /**< Hexadecimal digest string size. */
+    SCCHASHBLOCK = 64,                  /**< Compression block byte size. */
+    SCCHASHCHUNK = 1024,                /**< Chunk byte size. */
+    SCCHASHDEPTH = 54,                  /**< Max depth of the chunks tree. */
+} SccrollHashSizes;
+
+/**
+ * @struct SccrollHash
+ * @since 0.1.0
+ * @brief BLAKE3 hashing state.
+ * @note The fields are internals.
+ */
+typedef struct SccrollHash {
+    uint32_t cv[8];                  /**< Current chunk chaining value. */
+    uint8_t block[SCCHASHBLOCK];     /**< Current block. */
+    uint8_t blocklen;                /**< Current block length. */
+    uint8_t blocks;                  /**< Compressed blocks of the current chunk. */
+    uint64_t chunks;                 /**< Current chunk index. */
+    uint32_t stack[SCCHASHDEPTH][8]; /**< Chaining values of the subtrees. */
+    uint8_t stacklen;                /**< Number of stacked subtrees. */
+} SccrollHash;
+
+/**
+ * @since 0.1.0
+ * @brief Initialize a hashing state.
+ * @param hash The state to initialize.
+ */
+void sccroll_hashInit(SccrollHash* restrict hash) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Hash a part of a blob.
+ * @param hash The hashing state.
+ * @param blob The blob part.
+ * @param size The @p blob byte size.
+ */
+void sccroll_hashUpdate(SccrollHash* restrict hash, const void* restrict blob, size_t size)
+    __attribute__((nonnull(1)));
+
+/**
+ * @since 0.1.0
+ * @brief Give the digest of the hashed blob.
+ * @param hash The hashing state, which can still be updated
+ * afterwards.
+ * @param hex The lowercase hexadecimal digest string.
+ * @return @p hex.
+ */
+char* sccroll_hashFinal(const SccrollHash* restrict hash, char hex[SCCHASHHEX]) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Hash a whole blob.
+ * @param blob The blob, or @c NULL for an empty one.
+ * @param size The @p blob byte size.
+ * @param hex The lowercase hexadecimal digest string.
+ * @return @p hex.
+ */
+char* sccroll_hash(const void* restrict blob, size_t size, char hex[SCCHASHHEX]) __attribute__((nonnull(3)));
+
+/**
+ * @since 0.1.0
+ * @brief Hash a file content in a single streaming pass.
+ * @param stream The file stream, read until its end.
+ * @param hex The lowercase hexadecimal digest string.
+ * @return The number of bytes hashed, or @c -1 if the stream could
+ * not be read.
+ */
+long long sccroll_hashFile(FILE* restrict stream, char hex[SCCHASHHEX]) __attribute__((nonnull));
+
 // clang-format off
 
 /******************************************************************************
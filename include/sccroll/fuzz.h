@@ -0,0 +1,193 @@
+/**
+ * @file        fuzz.h
+ * @version     0.1.0
+ * @brief       Coverage-guided fuzzing of the tests standard input.
+ * @author      Alexandre Martos
+ * @email       contact@amartos.fr
+ * @copyright   2022-2023 Alexandre Martos <contact@amartos.fr>
+ * @license     MIT License
+ *
+ * @addtogroup API
+ * @{
+ * @addtogroup FuzzAPI Coverage-guided fuzzing
+ *
+ * Tests reading their data on the emulated standard input (see
+ * SccrollEffects::std) can be fuzzed: the inputs of a corpus
+ * directory are mutated and fed to the test wrapper, which is
+ * executed with the same isolation as any other test (see
+ * sccroll_exec()).
+ *
+ * The mutated inputs are kept in the corpus if they reach new parts
+ * of the tested code. This requires the tested code to be compiled
+ * with coverage instrumentation:
+ *
+ * - @c -fsanitize-coverage=trace-pc with GCC
+ * - @c -fsanitize-coverage=trace-pc-guard with Clang
+ *
+ * The coverage callbacks are defined by the library, which must thus
+ * **not** be compiled with these options. Without instrumentation,
+ * the inputs are still mutated and executed, but the corpus does not
+ * grow.
+ *
+ * The inputs provoking a crash (i.e. a signal) are saved in a
+ * dedicated directory, and can be used as is as a
+ * SccrollEffects::std::path of index #STDIN_FILENO to reproduce the
+ * crash in a regular test.
+ *
+ * ## Persistent mode
+ *
+ * By default, each input costs a whole test execution: preparation,
+ * fork, pipes and wait. When SccrollFuzz::persist is set, a single
+ * forked child executes the test wrapper in a loop over many inputs,
+ * and is only forked again after a crash, or after
+ * SccrollFuzz::persist inputs. Only the standard input is reset
+ * between two iterations; the standard outputs are discarded.
+ *
+ * This mode is thus meant for tests without side effects outliving an
+ * iteration (e.g. a parser on pure functions), as any global state
+ * modified by an input is seen by the following ones.
+ * @{
+ */
+
+#ifndef SCCROLL_FUZZ_H_
+#define SCCROLL_FUZZ_H_
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "sccroll/core.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio_ext.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// clang-format off
+
+/******************************************************************************
+ * @name Fuzzing
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @enum SccrollFuzzSizes
+ * @since 0.1.0
+ * @brief Fuzzing constants.
+ */
+typedef enum SccrollFuzzSizes {
+    SCCMAXINPUT = SCCMAX,  /**< Max byte size of an input. */
+    SCCMAPSIZE  = 1 << 16, /**< Byte size of the coverage map. */
+} SccrollFuzzSizes;
+
+/**
+ * @struct SccrollFuzz
+ * @since 0.1.0
+ * @brief Fuzzing options.
+ */
+typedef struct SccrollFuzz {
+    const char* corpus;  /**< Directory of the inputs to mutate. */
+    const char* crashes; /**< Directory where the crashing inputs are saved. */
+    const char** dict;   /**< @c NULL terminated array of tokens, or @c NULL. */
+    unsigned runs;       /**< Number of mutated inputs to execute. */
+    unsigned seed;       /**< Pseudo-random seed (@c 0 keeps the current one). */
+    unsigned persist;    /**< Inputs per persistent child (@c 0 forks for each input). */
+} SccrollFuzz;
+
+/**
+ * @since 0.1.0
+ * @brief Fuzz the standard input of a test.
+ *
+ * Each input of SccrollFuzz::corpus (truncated to #SCCMAXINPUT
+ * bytes) is first executed, and then SccrollFuzz::runs inputs are
+ * generated by mutation of the corpus (bits flips, bytes changes,
+ * insertions and deletions, splices of two inputs, and dictionary
+ * tokens), and executed. An empty input is used if the corpus is
+ * empty.
+ *
+ * The inputs reaching new coverage edges are saved in
+ * SccrollFuzz::corpus, and the crashing ones in
+ * SccrollFuzz::crashes. Both are named after the test name and the
+ * input content hash. The crashes are reported on stderr, unless
+ * #NODIFF is set.
+ *
+ * @param effects The test to fuzz. Its SccrollEffects::std of index
+ * #STDIN_FILENO is replaced by the fuzzed inputs, and the #NOSTRP
+ * option is always set.
+ * @param options The fuzzing options.
+ * @return The number of distinct crashing inputs found.
+ */
+int sccroll_fuzz(const SccrollEffects* restrict effects, const SccrollFuzz* restrict options)
+    __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Minimize a corpus.
+ *
+ * Each distinct input of SccrollFuzz::corpus is executed once, and a
+ * subset of the inputs preserving the whole corpus coverage (edges
+ * and hit counts classes) is saved in @p output. The smallest input
+ * reaching each coverage tuple is selected, unless the tuple is
+ * already reached by another selected input. Duplicated inputs are
+ * executed only once, and crashing inputs are dropped. The inputs
+ * longer than #SCCMAXINPUT bytes are skipped, and counted in the
+ * summary, as they would be truncated.
+ *
+ * Only SccrollFuzz::corpus and SccrollFuzz::persist are used. A
+ * summary is printed on stderr, unless #NODIFF is set.
+ *
+ * @param effects The test to execute (see sccroll_fuzz()).
+ * @param options The fuzzing options.
+ * @param output The minimized corpus directory. It must differ from
+ * SccrollFuzz::corpus.
+ * @return The number of inputs saved in @p output.
+ */
+int sccroll_minimize(const SccrollEffects* restrict effects, const SccrollFuzz* restrict options, const char* restrict output)
+    __attribute__((nonnull));
+
+// clang-format off
+
+/******************************************************************************
+ * @}
+ * @name Coverage instrumentation callbacks
+ *
+ * These functions are called by the instrumented code, and are not
+ * meant to be called directly.
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @since 0.1.0
+ * @brief Number the guards of an instrumented module (Clang).
+ * @param start,stop The module guards boundaries.
+ */
+void __sanitizer_cov_trace_pc_guard_init(uint32_t* start, uint32_t* stop);
+
+/**
+ * @since 0.1.0
+ * @brief Record the execution of an edge (Clang).
+ * @param guard The edge guard.
+ */
+void __sanitizer_cov_trace_pc_guard(uint32_t* guard);
+
+/**
+ * @since 0.1.0
+ * @brief Record the execution of an edge (GCC).
+ */
+void __sanitizer_cov_trace_pc(void);
+
+// clang-format off
+
+/******************************************************************************
+ * @}
+ ******************************************************************************/
+// clang-format on
+
+#endif // SCCROLL_FUZZ_H_
+/** @} @} */
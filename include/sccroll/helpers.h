@@ -165,7 +165,7 @@ int sccroll_simplefork(const char* restrict desc, SccrollFunc callback) __attrib
  * GNU C library.
  */
 #define attr_alias(storage, name, aliasname, ...)      \
-    attr_rename(storage, name, aliasname, alias(#name))
+    attr_rename(storage, name, aliasname, alias(#name), ##__VA_ARGS__)
 
 /**
  * @def strong_alias
@@ -31,19 +31,24 @@
 
 #include "sccroll/helpers.h"
 #include "sccroll/assert.h"
+#include "sccroll/clock.h"
 
 #ifndef _GNU_SOURCE
 #define _GNU_SOURCE
 #endif
 
 #include <dlfcn.h>
+#include <poll.h>
 #include <search.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <signal.h>
+#include <time.h>
 #include <unistd.h>
+#include <sys/select.h>
+#include <sys/time.h>
 
 // clang-format off
 
@@ -327,6 +332,15 @@ sccroll_mockPrototype(fscanf);
 sccroll_mockPrototype(fileno);
 sccroll_mockPrototype(hcreate);
 sccroll_mockPrototype(hsearch);
+sccroll_mockPrototype(time);
+sccroll_mockPrototype(clock_gettime);
+sccroll_mockPrototype(gettimeofday);
+sccroll_mockPrototype(sleep);
+sccroll_mockPrototype(usleep);
+sccroll_mockPrototype(nanosleep);
+sccroll_mockPrototype(clock_nanosleep);
+sccroll_mockPrototype(poll);
+sccroll_mockPrototype(select);
 /** @} */
 
 /**
@@ -353,6 +367,21 @@ sccroll_mockPrototype(hsearch);
 #define hsearch(...) sccroll_mockCall(hsearch, SCCEHSEARCH, __VA_ARGS__)
 /** @} */
 
+/**
+ * @name Virtual clock mocks overrides.
+ * @{
+ */
+#define time(...)            sccroll_mocktime(__VA_ARGS__)
+#define clock_gettime(...)   sccroll_mockclock_gettime(__VA_ARGS__)
+#define gettimeofday(...)    sccroll_mockgettimeofday(__VA_ARGS__)
+#define sleep(...)           sccroll_mocksleep(__VA_ARGS__)
+#define usleep(...)          sccroll_mockusleep(__VA_ARGS__)
+#define nanosleep(...)       sccroll_mocknanosleep(__VA_ARGS__)
+#define clock_nanosleep(...) sccroll_mockclock_nanosleep(__VA_ARGS__)
+#define poll(...)            sccroll_mockpoll(__VA_ARGS__)
+#define select(...)          sccroll_mockselect(__VA_ARGS__)
+/** @} */
+
 // clang-format off
 /******************************************************************************
  * @}
@@ -0,0 +1,44 @@
+#!/usr/bin/env bash
+# @file        pbench.sh
+# @version     0.1.0
+# @brief       Overhead benchmark printer.
+# @author      Alexandre Martos
+# @email       contact@amartos.fr
+# @copyright   2023 Alexandre Martos <contact@amartos.fr>
+# @license     MIT License
+#
+# @parblock
+# This script prints a formatted table of the startup time and the
+# per-test overhead of the benchmark binaries, averaged over several
+# runs. The overhead is given for forked and unforked tests.
+# Its parameters are:
+# - the number of runs
+# - the number of tests per run
+# - the benchmark binaries paths
+# @endparblock
+
+FORMAT="%-10s| %-10s | %12s | %12s | %12s |\n"
+RULEFMT="%-10s|------------+--------------+--------------+--------------|\n"
+RUNS=$1
+TESTS=$2
+
+# @brief Print the average time of a command, in microseconds.
+# @since 0.1.0
+# @param $1 The number of runs.
+# @param $@ The command.
+function elapsed {
+    local START=$(date +%s%N)
+    for ((RUN = 0; RUN < $1; ++RUN)); do "${@:2}" &> /dev/null; done
+    echo $((($(date +%s%N) - START) / $1 / 1000))
+}
+
+printf "$FORMAT" " " "variant" "startup (us)" "forked (us)" "unforked (us)"
+printf "$RULEFMT" " "
+for BIN in "${@:3}"; do
+    START=$(elapsed $RUNS $BIN)
+    FORKED=$(elapsed $RUNS $BIN $TESTS)
+    UNFORKED=$(elapsed $RUNS $BIN $TESTS nofork)
+    awk "BEGIN {printf \"$FORMAT\", \" \", \"${BIN##*.}\", $START, \
+        sprintf(\"%.2f\", ($FORKED - $START) / $TESTS), \
+        sprintf(\"%.2f\", ($UNFORKED - $START) / $TESTS)}"
+done
@@ -14,6 +14,195 @@
  */
 
 #include "sccroll/assert.h"
+#include "sccroll/data.h"
+
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+// clang-format off
+
+/******************************************************************************
+ * Preparation
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @struct SccrollWire
+ * @since 0.1.0
+ * @brief Header of a record sent by a test, followed by its
+ * strings.
+ */
+typedef struct SccrollWire {
+    uint32_t type;     /**< The SccrollRecord::type. */
+    int32_t line;      /**< The SccrollLocation::line. */
+    double value;      /**< The SccrollRecord::value. */
+    uint16_t sizes[3]; /**< The byte sizes of the file, expression and text strings, null bytes included. */
+} SccrollWire;
+
+/**
+ * @enum SccrollRecordSizes
+ * @since 0.1.0
+ * @brief Records constants.
+ */
+typedef enum SccrollRecordSizes {
+    RECORDSTRING  = 1024,             /**< Max byte size of a record string, truncated beyond. */
+    RECORDRESERVE = 4 * RECORDSTRING, /**< Byte size kept for the counts and the failed assertion records. */
+    RECORDFRAMES  = 32,               /**< Max number of frames of a crash backtrace. */
+} SccrollRecordSizes;
+
+/**
+ * @var channel
+ * @since 0.1.0
+ * @brief The records of the current test.
+ */
+static struct {
+    int fd;                      /**< The channel file descriptor, or @c -1. */
+    char records[SCCRECORDSMAX]; /**< The pending records. */
+    size_t len;                  /**< The byte size of the pending records. */
+    unsigned long failed;        /**< The number of failed soft assertions. */
+} channel = { .fd = -1 };
+
+/**
+ * @since 0.1.0
+ * @brief Serialize a record.
+ * @param buffer The destination buffer.
+ * @param size The number of bytes available in @p buffer.
+ * @param record The record.
+ * @return The number of bytes written, or @c 0 if the record does not
+ * fit in.
+ */
+static size_t sccroll_recordWrite(char* restrict buffer, size_t size, const SccrollRecord* restrict record)
+    __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Send a record through the channel if set, or add it to the
+ * pending ones otherwise, and drop it if they are full.
+ * @param record The record.
+ */
+static void sccroll_record(const SccrollRecord* restrict record) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Serialize the counts and the pending records, and forget the
+ * records.
+ * @param buffer The destination buffer.
+ * @param last A record to add after the pending ones, or @c NULL.
+ * @return The number of bytes written.
+ */
+static size_t sccroll_channelPack(char buffer[SCCRECORDSMAX], const SccrollRecord* restrict last)
+    __attribute__((nonnull(1)));
+
+/**
+ * @since 0.1.0
+ * @brief Send a failed assertion through the channel if set, or print
+ * it on stderr otherwise, then raise #SIGABRT.
+ * @param where The assertion location.
+ * @param fmt The message format string.
+ * @param args The format string arguments.
+ */
+static void sccroll_vassert(const SccrollLocation* restrict where, const char* restrict fmt, va_list args)
+    __attribute__((noreturn, nonnull(1, 2), format(printf, 2, 0)));
+
+/**
+ * @since 0.1.0
+ * @brief Record a soft assertion failure.
+ * @param where The assertion location.
+ * @param fmt The message format string.
+ * @param args The format string arguments.
+ */
+static void sccroll_vexpect(const SccrollLocation* restrict where, const char* restrict fmt, va_list args)
+    __attribute__((nonnull(1, 2), format(printf, 2, 0)));
+
+/**
+ * @enum SccrollArraySizes
+ * @since 0.1.0
+ * @brief Arrays comparison constants.
+ */
+typedef enum SccrollArraySizes {
+    ARRAYCHUNK  = 64, /**< Number of elements compared at once with a tolerance. */
+    ARRAYBEFORE = 2,  /**< Number of dumped elements before the first difference. */
+    ARRAYWINDOW = 8,  /**< Number of dumped elements. */
+    ARRAYBYTES  = 16, /**< Max number of dumped bytes of an opaque element. */
+} SccrollArraySizes;
+
+/**
+ * @def ARRAYFMT
+ * @since 0.1.0
+ * @brief Arrays comparison summary format string.
+ * @param zu The number of differing elements.
+ * @param zu The number of elements.
+ * @param zu The index of the first differing element.
+ */
+#define ARRAYFMT "\n%zu/%zu elements differ, first at index %zu:"
+
+/**
+ * @since 0.1.0
+ * @brief Count the differing elements of two arrays.
+ * @param array The comparison parameters.
+ * @param first The index of the first differing element, set if
+ * any.
+ * @return The number of differing elements.
+ */
+static size_t sccroll_arrayDiff(const SccrollArray* restrict array, size_t* restrict first) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Count the differing elements of two arrays, bitwise.
+ * @see sccroll_arrayDiff()
+ */
+static size_t sccroll_arrayExact(const SccrollArray* restrict array, size_t* restrict first) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Count the elements of two @c float arrays which are not
+ * near.
+ *
+ * The elements are compared by chunks without branches, so that the
+ * compiler vectorizes the loop, and only the chunks with a
+ * difference are searched for the first one.
+ *
+ * @see sccroll_arrayDiff()
+ */
+static size_t sccroll_arrayNearf(const SccrollArray* restrict array, size_t* restrict first) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Count the elements of two @c double arrays which are not
+ * near.
+ * @see sccroll_arrayNearf()
+ */
+static size_t sccroll_arrayNear(const SccrollArray* restrict array, size_t* restrict first) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Count the elements of two <tt>long double</tt> arrays which
+ * are not near.
+ * @see sccroll_arrayNearf()
+ */
+static size_t sccroll_arrayNearl(const SccrollArray* restrict array, size_t* restrict first) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Check if an element of two arrays differ.
+ * @param array The comparison parameters.
+ * @param index The element index.
+ * @return @c true if the elements differ, @c false otherwise.
+ */
+static bool sccroll_arrayDiffers(const SccrollArray* restrict array, size_t index) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Print an array element.
+ * @param stream The output stream.
+ * @param array The comparison parameters.
+ * @param blob The element.
+ */
+static void sccroll_arrayPrint(FILE* restrict stream, const SccrollArray* restrict array, const void* restrict blob)
+    __attribute__((nonnull));
 
 // clang-format off
 
@@ -39,9 +228,310 @@ void sccroll_fatal(int sigint, const char* restrict fmt, ...)
     sccroll_variadic(fmt, list, sccroll_vfatal(sigint, fmt, list), exit(1));
 }
 
+unsigned long sccroll_asserts = 0;
+
+void sccroll_channel(int fd) { channel.fd = fd; }
+
+int sccroll_channelFlush(int fd)
+{
+    char buffer[SCCRECORDSMAX];
+    return write(fd, buffer, sccroll_channelPack(buffer, NULL));
+}
+
+static size_t sccroll_recordWrite(char* restrict buffer, size_t size, const SccrollRecord* restrict record)
+{
+    const char* strings[3] = { record->where.file, record->where.expr, record->text };
+    SccrollWire wire = { .type = record->type, .line = record->where.line, .value = record->value };
+    size_t total = sizeof(wire);
+
+    for (int i = 0; i < 3; ++i) {
+        strings[i] = strings[i] ? strings[i] : "";
+        wire.sizes[i] = strnlen(strings[i], RECORDSTRING - 1) + 1;
+        total += wire.sizes[i];
+    }
+    if (total > size) return 0;
+
+    memcpy(buffer, &wire, sizeof(wire));
+    buffer += sizeof(wire);
+    for (int i = 0; i < 3; buffer += wire.sizes[i++]) {
+        memcpy(buffer, strings[i], wire.sizes[i] - 1);
+        buffer[wire.sizes[i] - 1] = 0;
+    }
+    return total;
+}
+
+size_t sccroll_recordRead(const char* restrict buffer, size_t size, SccrollRecord* restrict record)
+{
+    const char* strings[3] = { 0 };
+    SccrollWire wire = { 0 };
+    size_t total = sizeof(wire);
+
+    if (size < sizeof(wire)) return 0;
+    memcpy(&wire, buffer, sizeof(wire));
+    if (wire.type == RECORDEND) return 0;
+    for (int i = 0; i < 3; total += wire.sizes[i++]) {
+        // The strings must be null terminated within the buffer.
+        if (!wire.sizes[i] || total + wire.sizes[i] > size || buffer[total + wire.sizes[i] - 1]) return 0;
+        strings[i] = buffer + total;
+    }
+
+    *record = (SccrollRecord){
+        .type  = wire.type,
+        .where = { strings[0], wire.line, strings[1] },
+        .value = wire.value,
+        .text  = strings[2],
+    };
+    return total;
+}
+
+static void sccroll_record(const SccrollRecord* restrict record)
+{
+    char buffer[sizeof(SccrollWire) + 3 * RECORDSTRING];
+
+    // The channel of a forked test has no size limit, contrary to the
+    // pending records.
+    if (channel.fd >= 0 && write(channel.fd, buffer, sccroll_recordWrite(buffer, sizeof(buffer), record)) >= 0) return;
+    channel.len += sccroll_recordWrite(channel.records + channel.len, SCCRECORDSMAX - RECORDRESERVE - channel.len, record);
+}
+
+static size_t sccroll_channelPack(char buffer[SCCRECORDSMAX], const SccrollRecord* restrict last)
+{
+    size_t size = 0;
+    size += sccroll_recordWrite(buffer, SCCRECORDSMAX, &(SccrollRecord){ .type = RECORDCOUNT, .value = sccroll_asserts });
+    size += sccroll_recordWrite(buffer + size, SCCRECORDSMAX - size, &(SccrollRecord){ .type = RECORDFAILED, .value = channel.failed });
+    memcpy(buffer + size, channel.records, channel.len);
+    size += channel.len;
+    if (last) size += sccroll_recordWrite(buffer + size, SCCRECORDSMAX - size, last);
+    channel.len    = 0;
+    channel.failed = 0;
+    return size;
+}
+
+void sccroll_channelCrash(int sigint, siginfo_t* info, void* context)
+{
+    char buffer[SCCRECORDSMAX];
+    char text[RECORDSTRING];
+    void* frames[RECORDFRAMES];
+    Dl_info symbol = { 0 };
+    int count = backtrace(frames, RECORDFRAMES);
+    int len   = snprintf(text, sizeof(text), "SIG%s (code %i) at %p", sigabbrev_np(sigint), info->si_code, info->si_addr);
+
+    (void)context;
+    // The frames are located by their module offset, as the static
+    // functions have no symbol.
+    for (int i = 0; i < count && len > 0 && (size_t)len < sizeof(text); ++i) {
+        if (!dladdr(frames[i], &symbol)) symbol = (Dl_info){ 0 };
+        len += snprintf(
+            text + len, sizeof(text) - len, "\n#%i %s (%s+0x%tx)", i,
+            symbol.dli_sname ? symbol.dli_sname : "??", symbol.dli_fname ? symbol.dli_fname : "??",
+            (char*)frames[i] - (char*)symbol.dli_fbase
+        );
+    }
+
+    size_t size = sccroll_channelPack(buffer, &(SccrollRecord){ .type = RECORDSIGNAL, .value = sigint, .text = text });
+    if (channel.fd < 0 || write(channel.fd, buffer, size) < 0) fprintf(stderr, "%s\n", text);
+    // The handler is reset, and the signal is delivered once it
+    // returns.
+    __gcov_dump(), raise(sigint);
+}
+
+void sccroll_metric(const char* restrict name, double value)
+{
+    sccroll_record(&(SccrollRecord){ .type = RECORDMETRIC, .where.expr = name, .value = value });
+}
+
 void sccroll_assert(int expr, const char* restrict fmt, ...)
 {
-    if (!expr) sccroll_variadic(fmt, list, sccroll_vfatal(SIGABRT, fmt, list));
+    ++sccroll_asserts;
+    if (!expr) sccroll_variadic(fmt, list, sccroll_vassert(&(const SccrollLocation){ 0 }, fmt, list));
+}
+
+void sccroll_assertFailed(const SccrollLocation* restrict where, const char* restrict fmt, ...)
+{
+    // ibid for the exit.
+    sccroll_variadic(fmt, list, sccroll_vassert(where, fmt, list), exit(1));
+}
+
+static void sccroll_vassert(const SccrollLocation* restrict where, const char* restrict fmt, va_list args)
+{
+    char buffer[SCCRECORDSMAX];
+    char text[RECORDSTRING];
+
+    if (channel.fd < 0) {
+        if (where->file) fprintf(stderr, SCCLOCATIONFMT, where->file, where->line, where->expr);
+        sccroll_vfatal(SIGABRT, fmt, args);
+    }
+    vsnprintf(text, sizeof(text), fmt, args);
+    size_t size = sccroll_channelPack(buffer, &(SccrollRecord){ .type = RECORDASSERT, .where = *where, .text = text });
+    // The message is not lost if the runner cannot be reached.
+    if (write(channel.fd, buffer, size) < 0) fprintf(stderr, "%s\n", text);
+    __gcov_dump(), raise(SIGABRT), exit(1);
+}
+
+void sccroll_expect(int expr, const char* restrict fmt, ...)
+{
+    ++sccroll_asserts;
+    if (!expr) sccroll_variadic(fmt, list, sccroll_vexpect(&(const SccrollLocation){ 0 }, fmt, list));
+}
+
+void sccroll_expectFailed(const SccrollLocation* restrict where, const char* restrict fmt, ...)
+{
+    sccroll_variadic(fmt, list, sccroll_vexpect(where, fmt, list));
+}
+
+static void sccroll_vexpect(const SccrollLocation* restrict where, const char* restrict fmt, va_list args)
+{
+    char text[RECORDSTRING];
+
+    // The failures which do not fit in the records are only counted.
+    ++channel.failed;
+    vsnprintf(text, sizeof(text), fmt, args);
+    sccroll_record(&(SccrollRecord){ .type = RECORDEXPECT, .where = *where, .text = text });
+}
+
+void sccroll_assertArray(const SccrollArray* restrict array, const SccrollLocation* restrict where, const char* restrict fmt, ...)
+{
+    size_t first  = 0;
+    size_t count  = sccroll_arrayDiff(array, &first);
+    char* message = NULL;
+    size_t size   = 0;
+    FILE* stream  = NULL;
+
+    ++sccroll_asserts;
+    if (!count) return;
+    stream = open_memstream(&message, &size);
+    if (!stream) err(EXIT_FAILURE, "could not open the assertion message stream");
+    sccroll_variadic(fmt, list, vfprintf(stream, fmt, list));
+    fprintf(stream, ARRAYFMT, count, array->nmemb, first);
+
+    // The window is shifted to show the elements preceding the first
+    // difference.
+    size_t start = first > ARRAYBEFORE ? first - ARRAYBEFORE : 0;
+    size_t end   = start + ARRAYWINDOW < array->nmemb ? start + ARRAYWINDOW : array->nmemb;
+    for (size_t i = start; i < end; ++i) {
+        fprintf(stream, "\n%c [%zu] ", sccroll_arrayDiffers(array, i) ? '>' : ' ', i);
+        sccroll_arrayPrint(stream, array, (const char*)array->a + i * array->size);
+        fprintf(stream, " | ");
+        sccroll_arrayPrint(stream, array, (const char*)array->b + i * array->size);
+    }
+    fclose(stream);
+    sccroll_assertFailed(where, "%s", message);
+}
+
+static size_t sccroll_arrayDiff(const SccrollArray* restrict array, size_t* restrict first)
+{
+    if (array->tolerance < 0) return sccroll_arrayExact(array, first);
+    switch (array->type) {
+    case SCCARRAYFLOAT: return sccroll_arrayNearf(array, first);
+    case SCCARRAYDOUBLE: return sccroll_arrayNear(array, first);
+    case SCCARRAYLDOUBLE: return sccroll_arrayNearl(array, first);
+    default: return sccroll_arrayExact(array, first);
+    }
+}
+
+static size_t sccroll_arrayExact(const SccrollArray* restrict array, size_t* restrict first)
+{
+    const uint8_t* a = array->a;
+    const uint8_t* b = array->b;
+    size_t bytes     = array->nmemb * array->size;
+    size_t count     = 0;
+
+    // Only the differing elements are visited, the equal spans being
+    // skipped at once.
+    for (size_t offset = 0; (offset += blobspan(a + offset, b + offset, bytes - offset, true)) < bytes;) {
+        if (!count++) *first = offset / array->size;
+        offset = (offset / array->size + 1) * array->size;
+    }
+    return count;
+}
+
+static size_t sccroll_arrayNearf(const SccrollArray* restrict array, size_t* restrict first)
+{
+    const float* a = array->a;
+    const float* b = array->b;
+    float epsilon  = array->tolerance;
+    size_t count   = 0;
+
+    for (size_t i = 0; i < array->nmemb; i += ARRAYCHUNK) {
+        size_t end = i + ARRAYCHUNK < array->nmemb ? i + ARRAYCHUNK : array->nmemb;
+        size_t far = 0;
+        // NaN is never near, hence the negated comparisons.
+        for (size_t j = i; j < end; ++j) far += !(a[j] - b[j] <= epsilon && b[j] - a[j] <= epsilon);
+        if (far && !count)
+            for (*first = i; a[*first] - b[*first] <= epsilon && b[*first] - a[*first] <= epsilon; ++*first);
+        count += far;
+    }
+    return count;
+}
+
+static size_t sccroll_arrayNear(const SccrollArray* restrict array, size_t* restrict first)
+{
+    const double* a = array->a;
+    const double* b = array->b;
+    double epsilon  = array->tolerance;
+    size_t count    = 0;
+
+    for (size_t i = 0; i < array->nmemb; i += ARRAYCHUNK) {
+        size_t end = i + ARRAYCHUNK < array->nmemb ? i + ARRAYCHUNK : array->nmemb;
+        size_t far = 0;
+        for (size_t j = i; j < end; ++j) far += !(a[j] - b[j] <= epsilon && b[j] - a[j] <= epsilon);
+        if (far && !count)
+            for (*first = i; a[*first] - b[*first] <= epsilon && b[*first] - a[*first] <= epsilon; ++*first);
+        count += far;
+    }
+    return count;
+}
+
+static size_t sccroll_arrayNearl(const SccrollArray* restrict array, size_t* restrict first)
+{
+    const long double* a = array->a;
+    const long double* b = array->b;
+    long double epsilon  = array->tolerance;
+    size_t count         = 0;
+
+    for (size_t i = 0; i < array->nmemb; ++i) {
+        if (a[i] - b[i] <= epsilon && b[i] - a[i] <= epsilon) continue;
+        if (!count++) *first = i;
+    }
+    return count;
+}
+
+static bool sccroll_arrayDiffers(const SccrollArray* restrict array, size_t index)
+{
+    size_t first = 0;
+    SccrollArray element = *array;
+    element.a     = (const char*)array->a + index * array->size;
+    element.b     = (const char*)array->b + index * array->size;
+    element.nmemb = 1;
+    return sccroll_arrayDiff(&element, &first);
+}
+
+static void sccroll_arrayPrint(FILE* restrict stream, const SccrollArray* restrict array, const void* restrict blob)
+{
+    const unsigned char* bytes = blob;
+    long long integer          = 0;
+    unsigned long long natural = 0;
+
+    switch (array->type) {
+    case SCCARRAYINT:
+    case SCCARRAYUINT:
+        switch (array->size) {
+        case sizeof(int8_t): integer = *(const int8_t*)blob, natural = *(const uint8_t*)blob; break;
+        case sizeof(int16_t): integer = *(const int16_t*)blob, natural = *(const uint16_t*)blob; break;
+        case sizeof(int32_t): integer = *(const int32_t*)blob, natural = *(const uint32_t*)blob; break;
+        default: integer = *(const int64_t*)blob, natural = *(const uint64_t*)blob; break;
+        }
+        if (array->type == SCCARRAYINT) fprintf(stream, "%lld", integer);
+        else fprintf(stream, "%llu", natural);
+        break;
+    case SCCARRAYFLOAT: fprintf(stream, "%.9g", *(const float*)blob); break;
+    case SCCARRAYDOUBLE: fprintf(stream, "%.17g", *(const double*)blob); break;
+    case SCCARRAYLDOUBLE: fprintf(stream, "%.21Lg", *(const long double*)blob); break;
+    default: // SCCARRAYBYTES
+        for (size_t i = 0; i < array->size && i < ARRAYBYTES; ++i) fprintf(stream, "%02x", bytes[i]);
+        if (array->size > ARRAYBYTES) fprintf(stream, "...");
+        break;
+    }
 }
 
 /** @} @} */
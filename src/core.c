@@ -14,6 +14,8 @@
  */
 
 #include "sccroll/core.h"
+#include "sccroll/assert.h"
+#include "sccroll/clock.h"
 
 // clang-format off
 
@@ -167,6 +169,52 @@ static void sccroll_void(void) __attribute__((unused));
  */
 static List* tests = NULL;
 
+/**
+ * @since 0.1.0
+ * @var fixtures
+ * @brief List of registered SccrollFixture.
+ */
+static List* fixtures = NULL;
+
+/**
+ * @since 0.1.0
+ * @brief Find a registered fixture by name.
+ * @param expected The test using the fixture.
+ * @return The SccrollFixture named by the @p expected
+ * SccrollEffects::fixture.
+ * @throw #EXIT_FAILURE if no such fixture is registered.
+ */
+static const SccrollFixture* sccroll_fixtureFind(const SccrollEffects* restrict expected) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @var suites
+ * @brief List of registered SccrollSuite.
+ */
+static List* suites = NULL;
+
+/**
+ * @since 0.1.0
+ * @brief Find a registered suite by name.
+ * @param name The suite name.
+ * @return The SccrollSuite named @p name, or @c NULL if @p name is
+ * @c NULL or no such suite is registered.
+ */
+static const SccrollSuite* sccroll_suiteFind(const char* restrict name);
+
+/**
+ * @since 0.1.0
+ * @brief Move the tests sharing a field value with a test from a
+ * queue to a new list.
+ * @param first The test, which heads the list.
+ * @param queue The queue of tests.
+ * @param field The offset of the compared name in SccrollEffects
+ * (SccrollEffects::suite or SccrollEffects::fixture). Two @c NULL
+ * names are equal.
+ * @return The list of the gathered tests, in the @p queue order.
+ */
+static List* sccroll_gather(SccrollEffects* restrict first, List* restrict queue, size_t field) __attribute__((nonnull));
+
 // clang-format off
 
 /******************************************************************************
@@ -182,9 +230,55 @@ static List* tests = NULL;
  * @brief Shallow copy the given SccrollEffects.
  * @param effects The SccrollEffects struct to copy.
  * @return A malloc'ed pointer to an @p effects shallow copy.
+ * @note The SccrollEffects::std given by path are not loaded (see
+ * sccroll_load()).
  */
 static SccrollEffects* sccroll_dup(const SccrollEffects* restrict effects) __attribute__((nonnull));
 
+/**
+ * @since 0.1.0
+ * @brief Load the SccrollEffects::std given by path, if not already
+ * done.
+ *
+ * The files are thus read only for the tests actually executed, and
+ * only once.
+ *
+ * @param effects The prepared test.
+ */
+static void sccroll_load(SccrollEffects* restrict effects) __attribute__((nonnull));
+
+/**
+ * @struct SccrollResult
+ * @since 0.1.0
+ * @brief Obtained effects of a test.
+ *
+ * Contrary to a SccrollEffects, this structure only stores what is
+ * recorded during the test execution; the expectations are never
+ * copied in it.
+ */
+typedef struct SccrollResult {
+    int code;              /**< The obtained SccrollEffects::code value. */
+    const char* limit;     /**< The description of the exceeded limit, if any. */
+    pid_t pid;             /**< The test process id. */
+    struct rusage usage;   /**< The test process resources usage, if forked. */
+    unsigned long asserts; /**< The number of checked assertions. */
+    int expects;           /**< The number of failed soft assertions. */
+    Data records;          /**< The records sent by the test. */
+    SccrollRecord failure; /**< The failed assertion or crash which stopped the test, if any. */
+    Data std[SCCMAXSTD];   /**< The obtained standard outputs (the input is unused), sized before their trimming. */
+    size_t len;            /**< The number of SccrollResult::files. */
+    Data files[];          /**< The obtained SccrollEffects::files, by index. */
+} SccrollResult;
+
+/**
+ * @since 0.1.0
+ * @brief Create the structure storing the obtained effects of a test.
+ * @param expected The test.
+ * @return A pointer to a zeroed result structure in the test #arena,
+ * sized for the @p expected files.
+ */
+static SccrollResult* sccroll_result(const SccrollEffects* restrict expected) __attribute__((nonnull));
+
 /**
  * @since 0.1.0
  * @brief Malloc a SccrollEffects struct initialised at 0.
@@ -225,12 +319,54 @@ static char* sccroll_strip(const char* string) __attribute__((nonnull));
 
 /**
  * @since 0.1.0
- * @brief Read the file content and store it.
- * @param file The structure storing the file path and content pointer
- * destination.
+ * @brief Strip a string of its left and right whitespaces, in place.
+ * @param string The string to strip.
+ * @return A pointer to the first non-whitespace character of
+ * @p string.
+ */
+static char* sccroll_trim(char* string) __attribute__((nonnull));
+
+/**
+ * @var arena
+ * @since 0.1.0
+ * @brief Arena of the allocations of the running test.
+ *
+ * It backs the results, the loaded expectations and the diffs
+ * buffers, and is reset after each test.
+ */
+static SccrollArena arena = { 0 };
+
+/**
+ * @since 0.1.0
+ * @brief Copy a blob in the test #arena, with a trailing null byte.
+ * @param blob The blob to copy.
+ * @param size The byte size of @p blob.
+ * @param name The test name.
+ * @return The copy.
+ */
+static void* sccroll_adup(const void* restrict blob, size_t size, const char* restrict name) __attribute__((nonnull(3)));
+
+/**
+ * @since 0.1.0
+ * @brief Read the file content and store it in the test #arena.
+ * @param path The file path.
+ * @param content The content destination.
  * @param name The parent test name.
  */
-static void sccroll_fread(SccrollFile* restrict file, const char* restrict name) __attribute__((nonnull));
+static void sccroll_fread(const char* restrict path, Data* restrict content, const char* restrict name) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Hash a file content.
+ *
+ * Data::blob is set to the digest string (in the test #arena), and
+ * Data::size to the file byte size.
+ *
+ * @param path The file path.
+ * @param content The digest destination.
+ * @param name The test name.
+ */
+static void sccroll_fhash(const char* restrict path, Data* restrict content, const char* restrict name) __attribute__((nonnull));
 
 // clang-format off
 
@@ -252,15 +388,148 @@ static int sccroll_main(void);
 
 /**
  * @since 0.1.0
- * @brief Run the next scheduled test.
+ * @brief Run a scheduled test.
+ * @param expected The test, freed once run.
  * @return @c 1 if the test failed, @c 0 otherwise.
  */
-static int sccroll_test(void);
+static int sccroll_test(SccrollEffects* restrict expected) __attribute__((nonnull));
 
 /**
  * @since 0.1.0
- * @brief Execute the test wrapper and record side effects in the
- * given structure.
+ * @brief Run the tests sharing the fixture of a test, in a dedicated
+ * process.
+ *
+ * The fixture process builds the SccrollFixture state once, then
+ * runs the tests, each forked from it (see sccroll_fixture()).
+ *
+ * @param group The tests of the fixture, freed once run.
+ * @return The number of failed tests of the group.
+ */
+static int sccroll_group(List* restrict group) __attribute__((nonnull));
+
+/**
+ * @enum SccrollSuiteSizes
+ * @since 0.1.0
+ * @brief Suites numerical constants.
+ */
+typedef enum SccrollSuiteSizes {
+    SUITEBUFFER = 1 << 20, /**< Size of the reports buffer of a worker. */
+} SccrollSuiteSizes;
+
+/**
+ * @since 0.1.0
+ * @brief Check if a suite is selected by the #SCCSUITES filter.
+ * @param filter The filter value.
+ * @param name The suite name.
+ * @return @c true if @p filter is @c NULL or empty, or lists @p name,
+ * @c false otherwise.
+ */
+static bool sccroll_selected(const char* restrict filter, const char* restrict name);
+
+/**
+ * @since 0.1.0
+ * @brief Run the tests of a suite between its hooks.
+ * @param group The tests of the suite, freed once run.
+ * @return The number of failed tests of the suite.
+ */
+static int sccroll_suiteRun(List* restrict group) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Run a queue of tests, possibly in parallel.
+ *
+ * The queue is split in units, either a single test or the tests of
+ * a same fixture. If more than one job is allowed, the units are
+ * dispatched to as many worker processes (see sccroll_worker()).
+ *
+ * @param queue The tests to run, freed once run.
+ * @param suite The suite of the tests, or @c NULL.
+ * @return The number of failed tests of @p queue. The units of a
+ * worker which did not end normally are considered failed.
+ */
+static int sccroll_schedule(List* restrict queue, const SccrollSuite* restrict suite) __attribute__((nonnull(1)));
+
+/**
+ * @struct SccrollPool
+ * @since 0.1.0
+ * @brief Data shared by the workers of a suite.
+ */
+typedef struct SccrollPool {
+    const SccrollSuite* suite; /**< The suite run. */
+    List* units;               /**< The units to run. */
+    size_t* next;              /**< The index of the next unit to run, shared. */
+    int* results;              /**< The units results, shared. */
+    int cpus[CPU_SETSIZE];     /**< The CPUs the workers are pinned to. */
+    int ncpus;                 /**< The number of SccrollPool::cpus. */
+} SccrollPool;
+
+/**
+ * @var workers
+ * @since 0.1.0
+ * @brief Whether the suites workers report their utilization.
+ * @see #SCCWORKERS
+ */
+static bool workers = false;
+
+/**
+ * @since 0.1.0
+ * @brief Run the units of a pool until none is left, and exit.
+ *
+ * The worker picks the next unit as soon as it is done with one.
+ * Its reports are buffered, and printed at once at the end of each
+ * unit.
+ *
+ * @param pool The workers pool.
+ * @param index The worker index.
+ */
+static void sccroll_worker(const SccrollPool* restrict pool, int index) __attribute__((nonnull, noreturn));
+
+/**
+ * @since 0.1.0
+ * @brief Parse the SccrollSuite::cpus list.
+ * @param suite The suite.
+ * @param cpus The array receiving the CPUs numbers.
+ * @return The number of CPUs of the list.
+ * @throw #EXIT_FAILURE if the list is invalid or empty.
+ */
+static int sccroll_cpus(const SccrollSuite* restrict suite, int cpus[CPU_SETSIZE]) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Pin the current process to a CPU and, if required by the
+ * suite, its memory to the CPU NUMA node.
+ * @param suite The suite.
+ * @param cpu The CPU number.
+ * @throw #EXIT_FAILURE if the process cannot be pinned.
+ */
+static void sccroll_pin(const SccrollSuite* restrict suite, int cpu) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Give the NUMA node of a CPU.
+ * @param cpu The CPU number.
+ * @return The node number, or @c -1 if unknown.
+ */
+static int sccroll_node(int cpu);
+
+/**
+ * @since 0.1.0
+ * @brief Run a unit of sccroll_schedule().
+ * @param unit The tests of the unit, freed once run.
+ * @return The number of failed tests of @p unit.
+ */
+static int sccroll_unit(List* restrict unit) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Free a list of tests, without running them.
+ * @param list The list to free.
+ */
+static void sccroll_lfree(List* restrict list) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Execute the test wrapper and record its side effects.
  *
  * The recorded data include:
  * - the errno value after the call (errno is reset before the call)
@@ -274,11 +543,332 @@ static int sccroll_test(void);
  * @todo prevent side effects on files
  * @attention If #NOFORK is set, the wrapper is directly called. If
  * not, the wrapper is called in a fork.
- * @param result The structure storing the wrapper function pointer
- * and used as a destination for the side effects analysis.
- * @return @p result but now storing the side effects.
+ * @param expected The test.
+ * @return A structure storing the side effects, in the test #arena.
+ */
+static SccrollResult* sccroll_exe(const SccrollEffects* restrict expected) __attribute__((nonnull));
+
+// clang-format off
+
+/******************************************************************************
+ * @}
+ *
+ * @name Runner profiling
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @enum SccrollPhase
+ * @since 0.1.0
+ * @brief Phases of a test execution measured by the profiling.
+ */
+typedef enum SccrollPhase {
+    PHASELOAD,    /**< Expectations loading. */
+    PHASEPIPES,   /**< Pipes setup. */
+    PHASEFORK,    /**< Fork. */
+    PHASESTDIN,   /**< Standard input writing. */
+    PHASETEST,    /**< Test wrapper execution. */
+    PHASEWAIT,    /**< Wait for the test process. */
+    PHASECAPTURE, /**< Codes and standard outputs capture. */
+    PHASEFILES,   /**< Files reading. */
+    PHASEDIFF,    /**< Comparisons, updates and reports. */
+    PHASEMAX,     /**< Number of phases. */
+} SccrollPhase;
+
+/**
+ * @var PHASEDESC
+ * @since 0.1.0
+ * @brief SccrollPhase descriptions.
+ */
+static const char* PHASEDESC[PHASEMAX] = {
+    "load", "pipes", "fork", "stdin", "test", "wait", "capture", "files", "diff",
+};
+
+/**
+ * @struct SccrollProfile
+ * @since 0.1.0
+ * @brief Per-phase timings, aggregated over a run.
+ */
+typedef struct SccrollProfile {
+    uint64_t count[PHASEMAX]; /**< Number of measures of each phase. */
+    uint64_t nsecs[PHASEMAX]; /**< Total duration of each phase, in nanoseconds. */
+} SccrollProfile;
+
+/**
+ * @var profile
+ * @since 0.1.0
+ * @brief The run timings, shared by all the tests processes; @c NULL
+ * if the profiling is disabled.
+ * @see #SCCPROFILE
+ */
+static SccrollProfile* profile = NULL;
+
+/**
+ * @def PROFILEFMT
+ * @since 0.1.0
+ * @brief Phase timings format string.
+ * @param s The phase description.
+ * @param PRIu64 The number of measures.
+ * @param f The total duration, in milliseconds.
+ * @param f The mean duration, in microseconds.
+ */
+#define PROFILEFMT BASEFMT ": %" PRIu64 " calls, %.3f ms, %.3f us per call\n", BOLD, CYAN, "PROF"
+
+/**
+ * @since 0.1.0
+ * @brief Give the current monotonic time, if the profiling or the
+ * tracing is enabled.
+ * @return The time in nanoseconds, or @c 0 if both are disabled.
+ */
+static uint64_t sccroll_clock(void);
+
+/**
+ * @since 0.1.0
+ * @brief Record the end of a phase in the profile and the trace.
+ * @param phase The phase.
+ * @param start The sccroll_clock() value at the start of the phase.
+ * @return The sccroll_clock() value at the end of the phase, which
+ * is the start of the next one.
+ */
+static uint64_t sccroll_phase(SccrollPhase phase, uint64_t start);
+
+/**
+ * @since 0.1.0
+ * @brief Print the profiling breakdown.
+ */
+static void sccroll_profile(void);
+
+// clang-format off
+
+/******************************************************************************
+ * @}
+ *
+ * @name Runner tracing
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @enum SccrollTraceSizes
+ * @since 0.1.0
+ * @brief Tracing numerical constants.
+ */
+typedef enum SccrollTraceSizes {
+    TRACEBUFFER = 4096, /**< Maximal size of a trace event. */
+    TRACENAME   = 1024, /**< Maximal size of an escaped name. */
+} SccrollTraceSizes;
+
+/**
+ * @var tracefd
+ * @since 0.1.0
+ * @brief The trace file descriptor, shared by all the tests
+ * processes; @c -1 if the tracing is disabled.
+ * @see #SCCTRACE
+ */
+static int tracefd = -1;
+
+/**
+ * @var lane
+ * @since 0.1.0
+ * @brief The trace lane of the current process: @c 0 for the tests
+ * runner, the worker index plus one for the suites workers.
+ */
+static int lane = 0;
+
+/**
+ * @var tracepid
+ * @since 0.1.0
+ * @brief The tests runner process id, used as the trace process id.
+ */
+static pid_t tracepid = 0;
+
+/**
+ * @since 0.1.0
+ * @brief Open the trace file, and name the tests runner lane.
+ * @param path The trace file path.
+ * @throw #EXIT_FAILURE if the file cannot be opened.
+ */
+static void sccroll_traceOpen(const char* restrict path) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Close the trace file, and end its events list.
+ */
+static void sccroll_traceClose(void);
+
+/**
+ * @since 0.1.0
+ * @brief Name the current lane.
+ * @param name The lane name.
+ */
+static void sccroll_traceLane(const char* restrict name) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Add a span to the current lane.
+ * @param name The span name.
+ * @param category The span category.
+ * @param start The sccroll_clock() value at the start of the span.
+ * @param end The sccroll_clock() value at the end of the span.
+ * @param args The span arguments, as a JSON object, or @c NULL.
+ */
+static void sccroll_traceSpan(const char* restrict name, const char* restrict category, uint64_t start, uint64_t end, const char* restrict args)
+    __attribute__((nonnull(1, 2)));
+
+/**
+ * @since 0.1.0
+ * @brief Add the span of a test to the current lane.
+ * @param expected The test.
+ * @param result The test results.
+ * @param failed Whether the test failed.
+ * @param start The sccroll_clock() value at the start of the test.
+ */
+static void sccroll_traceTest(const SccrollEffects* restrict expected, const SccrollResult* restrict result, bool failed, uint64_t start)
+    __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Write a trace event at once.
+ *
+ * The trace file is opened in append mode, thus the events of the
+ * concurrent processes are not interleaved.
+ *
+ * @param format The event format string.
+ * @param ... The format arguments.
+ */
+static void sccroll_traceWrite(const char* restrict format, ...) __attribute__((nonnull(1), format(printf, 1, 2)));
+
+/**
+ * @since 0.1.0
+ * @brief Escape a string for a JSON string value.
+ * @param dest The escaped string buffer, of #TRACENAME bytes. The
+ * string is truncated if too long.
+ * @param src The string to escape.
+ * @return @p dest.
+ */
+static char* sccroll_escape(char dest[TRACENAME], const char* restrict src) __attribute__((nonnull));
+
+// clang-format off
+
+/******************************************************************************
+ * @}
+ *
+ * @name Crash forensics
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @enum SccrollCrashSizes
+ * @since 0.1.0
+ * @brief Crash handling constants.
+ */
+typedef enum SccrollCrashSizes {
+    CRASHSTACK = 1 << 16, /**< Byte size of the crash handler stack. */
+} SccrollCrashSizes;
+
+/**
+ * @since 0.1.0
+ * @brief Install sccroll_channelCrash() in a forked test for the
+ * crash signals.
+ *
+ * The handler runs on an alternate stack, so that a stack overflow
+ * is reported too.
+ *
+ * @param expected The test.
+ * @throw #EXIT_FAILURE if the handler cannot be installed.
  */
-static const SccrollEffects* sccroll_exe(SccrollEffects* restrict result) __attribute__((nonnull));
+static void sccroll_forensics(const SccrollEffects* restrict expected) __attribute__((nonnull));
+
+// clang-format off
+
+/******************************************************************************
+ * @}
+ *
+ * @name Resources limits
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @since 0.1.0
+ * @brief Give the cgroup of the tests runner, if it can host the
+ * tests cgroups.
+ *
+ * The cgroup must be in the cgroup v2 hierarchy, writable, and the
+ * memory controller must be available to it. The runner is moved to
+ * a leaf of this cgroup, and the memory controller is enabled for
+ * its children; if this fails, the runner is moved back. It is
+ * looked up only once.
+ *
+ * @return The cgroup directory path, or @c NULL if the cgroups are
+ * not usable.
+ */
+static const char* sccroll_cgroup(void);
+
+/**
+ * @since 0.1.0
+ * @brief Tell if a cgroup controllers list holds a controller.
+ * @param leaf The cgroup path.
+ * @param name The controllers list interface file name.
+ * @param controller The controller name.
+ * @return @c true if the list holds the controller, @c false
+ * otherwise.
+ */
+static bool sccroll_cgroupHas(const char* restrict leaf, const char* restrict name, const char* restrict controller)
+    __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Create the cgroup of a test, if it has a memory limit and
+ * the cgroups are usable.
+ * @param expected The test.
+ * @param leaf A buffer of #PATH_MAX bytes receiving the created
+ * cgroup path, or an empty string.
+ */
+static void sccroll_cgroupOpen(const SccrollEffects* restrict expected, char* restrict leaf) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Write a value in a cgroup interface file.
+ * @param leaf The cgroup path.
+ * @param name The interface file name.
+ * @param format The value format string.
+ * @param ... The format arguments.
+ * @return @c true if the value was written, @c false otherwise.
+ */
+static bool sccroll_cgroupWrite(const char* restrict leaf, const char* restrict name, const char* restrict format, ...)
+    __attribute__((nonnull(1, 2, 3), format(printf, 3, 4)));
+
+/**
+ * @since 0.1.0
+ * @brief Apply the resources limits of a test in its process.
+ *
+ * The process joins the test cgroup, if any, and its limits are
+ * lowered with setrlimit(). The CPU time hard limit is one second
+ * above the soft one, so that the test is stopped by @c SIGXCPU.
+ *
+ * @param expected The test.
+ * @param leaf The test cgroup path, or an empty string.
+ * @throw #EXIT_FAILURE if a limit cannot be set.
+ */
+static void sccroll_limit(const SccrollEffects* restrict expected, const char* restrict leaf) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Find the limit exceeded by a test, and remove its cgroup.
+ * @param expected The test.
+ * @param status The wait() status of the test process.
+ * @param usage The resources used by the test process.
+ * @param leaf The test cgroup path, or an empty string.
+ * @return The description of the exceeded limit, or @c NULL if the
+ * test did not exceed any, or expected to be stopped by the
+ * corresponding signal.
+ */
+static const char* sccroll_breach(
+    const SccrollEffects* restrict expected, int status, const struct rusage* restrict usage, const char* restrict leaf
+) __attribute__((nonnull));
 
 // clang-format off
 
@@ -301,8 +891,10 @@ typedef enum SccrollPipes {
     PIPEOPEN,     /**< Pipe open operation code. */
     PIPECLOSE,    /**< Pipe close operation code. */
     PIPEDUP,      /**< Pipe dupe operation code. */
+    PIPEMEMFD,    /**< Memory file open operation code. */
     PIPEMAX,      /**< Max index of pipe operations. */
     PIPEERRN = SCCMAXSTD, /**< Index of the errno pipe in an array of pipes. */
+    PIPEASRT,             /**< Index of the assertions memory file in an array of pipes. */
     PIPEMAXFD,            /**< Max index of an array of pipes. */
 } SccrollPipes;
 
@@ -314,7 +906,7 @@ typedef enum SccrollPipes {
 const char* const PIPEDESC[PIPEMAX] = {
     "read pipe", "write pipe",
     "open pipe", "close pipe",
-    "duplicate pipe"
+    "duplicate pipe", "open memory file",
 };
 
 /**
@@ -333,6 +925,7 @@ const char* const PIPEDESC[PIPEMAX] = {
  * | #PIPEWRTE  | a pointer to the data to write in the pipe, the bytes size of the data to write            |
  * | #PIPEREAD  | a pointer to a #SCCMAX string used to store the data to read in the pipe                   |
  * | #PIPEDUP   | #PIPEREAD or #PIPEWRTE depending on the side to duplicate, the destination file descriptor |
+ * | #PIPEMEMFD | ignored; both sides are descriptors of the same memory file                                |
  */
 static void sccroll_pipes(SccrollPipes type, const char* restrict name, int pipefd[2], ...) __attribute__((nonnull(2, 3)));
 
@@ -349,29 +942,53 @@ static void sccroll_pipes(SccrollPipes type, const char* restrict name, int pipe
 /**
  * @since 0.1.0
  * @brief Store the error codes of a test.
+ * @param expected The test.
  * @param result The destination structure.
  * @param pipefd The pipe containing the code value.
  * @param status The wait() (defaults to @c 0 if #NOFORK is set).
  */
-static void sccroll_codes(SccrollEffects* restrict result, int pipefd[2], int status) __attribute__((nonnull(1,2)));
+static void sccroll_codes(const SccrollEffects* restrict expected, SccrollResult* restrict result, int pipefd[2], int status)
+    __attribute__((nonnull(1, 2, 3)));
 
 /**
  * @since 0.1.0
  * @brief Store the standard outputs of the test.
+ * @param expected The test.
  * @param result The destination structure.
  * @param pipestd An array of pipes used to capture the standard
  * outputs. The indexes correspond to the standard outputs file
  * descriptors values.
  */
-static void sccroll_std(SccrollEffects* restrict result, int pipestd[SCCMAXSTD][2]) __attribute__((nonnull));
+static void sccroll_std(const SccrollEffects* restrict expected, SccrollResult* restrict result, int pipestd[SCCMAXSTD][2])
+    __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Send the records of the test: its number of checked
+ * assertions, its soft assertions failures and its metrics.
+ * @param expected The test.
+ * @param pipefd The memory file used to send the records.
+ */
+static void sccroll_assertsSend(const SccrollEffects* restrict expected, int pipefd[2]) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Store the records of the test.
+ * @param expected The test.
+ * @param result The destination structure.
+ * @param pipefd The memory file used to receive the records.
+ */
+static void sccroll_assertsRecv(const SccrollEffects* restrict expected, SccrollResult* restrict result, int pipefd[2])
+    __attribute__((nonnull));
 
 /**
  * @since 0.1.0
  * @brief Store the first #SCCMAX-1 characters of the
  * SccollEffects::files content.
+ * @param expected The test.
  * @param result The destination structure.
  */
-static void sccroll_files(SccrollEffects* restrict result) __attribute__((nonnull));
+static void sccroll_files(const SccrollEffects* restrict expected, SccrollResult* restrict result) __attribute__((nonnull));
 
 // clang-format off
 
@@ -393,6 +1010,8 @@ typedef enum SccrollReport {
     REPORTFAIL = 1,  /**< Index of the total number of failed tests. */
     REPORTMAX  = 2,  /**< Max index of the report count array. */
     MAXLINE = 80,    /**< Max line length. */
+    DUMPBEFORE = 8,  /**< Number of dumped bytes before the first difference of hashed files. */
+    DUMPWINDOW = 32, /**< Max number of dumped bytes of hashed files. */
 } SccrollReport;
 
 /**
@@ -414,6 +1033,15 @@ typedef enum SccrollReport {
  */
 static const char* SCCSEP = NULL;
 
+/**
+ * @var update
+ * @since 0.1.0
+ * @brief Whether the on-disk expectations are updated instead of
+ * compared.
+ * @see #SCCUPDATE
+ */
+static bool update = false;
+
 /**
  * @def REPORTFMT
  * @since 0.1.0
@@ -436,6 +1064,83 @@ static const char* SCCSEP = NULL;
  */
 #define DIFFFMT BASEFMT ": %s\n", BOLD, CYAN, "DIFF"
 
+/**
+ * @def FIXTUREFMT
+ * @since 0.1.0
+ * @brief Fixture process failure format string.
+ * @param s The fixture name.
+ * @param i The number of tests of the fixture.
+ */
+#define FIXTUREFMT BASEFMT ": fixture process failed, its %i tests are considered failed\n", BOLD, RED, "FAIL"
+
+/**
+ * @def LIMITFMT
+ * @since 0.1.0
+ * @brief Exceeded resource limit format string.
+ * @param s The test name.
+ * @param s The limit description.
+ */
+#define LIMITFMT BASEFMT ": %s limit exceeded\n", BOLD, RED, "LIMT"
+
+/**
+ * @def EXPECTFMT
+ * @since 0.1.0
+ * @brief Soft assertions failures format string, followed by the
+ * failures records.
+ * @param s The test name.
+ * @param i The number of failures.
+ */
+#define EXPECTFMT BASEFMT ": %i failed expectations\n", BOLD, CYAN, "EXPT"
+
+/**
+ * @def UNLISTEDFMT
+ * @since 0.1.0
+ * @brief Soft assertions failures not received format string.
+ * @param i The number of failures not listed.
+ */
+#define UNLISTEDFMT "%i more not listed\n"
+
+/**
+ * @def ASSERTFMT
+ * @since 0.1.0
+ * @brief Failed assertion format string, followed by its record.
+ * @param s The test name.
+ */
+#define ASSERTFMT BASEFMT ": ", BOLD, CYAN, "ASRT"
+
+/**
+ * @def SIGNALFMT
+ * @since 0.1.0
+ * @brief Crashed test format string.
+ * @param s The test name.
+ * @param s The signal description and backtrace.
+ */
+#define SIGNALFMT BASEFMT ": %s\n", BOLD, CYAN, "SGNL"
+
+/**
+ * @def METRICFMT
+ * @since 0.1.0
+ * @brief Test metric format string.
+ * @param s The test name.
+ * @param s The metric name.
+ * @param g The metric value.
+ */
+#define METRICFMT BASEFMT ": %s = %g\n", BOLD, CYAN, "METR"
+
+/**
+ * @def WORKERFMT
+ * @since 0.1.0
+ * @brief Suite worker utilization format string.
+ * @param s The suite name.
+ * @param i The worker index.
+ * @param s The worker CPU.
+ * @param i The number of units run.
+ * @param f The CPU time, in seconds.
+ * @param f The lifetime, in seconds.
+ * @param f The utilization percentage.
+ */
+#define WORKERFMT BASEFMT ": worker %i on CPU %s: %i units, %.2fs busy over %.2fs (%.0f%%)\n", BOLD, CYAN, "WORK"
+
 /**
  * @def CODEFMT
  * @since 0.1.0
@@ -449,6 +1154,37 @@ static const char* SCCSEP = NULL;
  */
 #define CODEFMT BASEFMT ": %s: expected %i (%s), got %i (%s)\n", BOLD, CYAN, "DIFF"
 
+/**
+ * @def HASHFMT
+ * @since 0.1.0
+ * @brief Expected/obtained file digest format string.
+ * @param s The digest description.
+ * @param i A SccrollFonts code.
+ * @param i A SccrollColors code.
+ * @param s The digest.
+ * @param zu The file byte size.
+ */
+#define HASHFMT "%s (hash): " COLSTRFMT " [%zu bytes]\n"
+
+/**
+ * @def UPDATEFMT
+ * @since 0.1.0
+ * @brief Updated expectation file format string.
+ * @param s The test name.
+ * @param s The updated file path.
+ */
+#define UPDATEFMT BASEFMT ": %s\n", BOLD, CYAN, "UPDT"
+
+/**
+ * @def NOUPDATEFMT
+ * @since 0.1.0
+ * @brief Expectation file not updatable format string.
+ * @param s The test name.
+ * @param s The expectation file path.
+ * @param s The reason.
+ */
+#define NOUPDATEFMT BASEFMT ": %s not updated, %s\n", BOLD, RED, "UPDT"
+
 /**
  * @since 0.1.0
  * @brief Diff two SccrollEffects.
@@ -460,7 +1196,7 @@ static const char* SCCSEP = NULL;
  * @return @c true if the @p expected effects and @p results are
  * different, @c false otherwise.
  */
-static bool sccroll_diff(const SccrollEffects* restrict expected, const SccrollEffects* restrict result)
+static bool sccroll_diff(const SccrollEffects* restrict expected, const SccrollResult* restrict result)
     __attribute__((nonnull));
 
 /**
@@ -474,9 +1210,33 @@ static bool sccroll_diff(const SccrollEffects* restrict expected, const SccrollE
  * @return @c true if the @p expected codes and @p results codes are
  * different, @c false otherwise.
  */
-static bool sccroll_diffCodes(const SccrollEffects* restrict expected, const SccrollEffects* restrict result)
+static bool sccroll_diffCodes(const SccrollEffects* restrict expected, const SccrollResult* restrict result)
+    __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Check the assertions of a test.
+ *
+ * If #NODIFF is **not** defined, the function print a report listing
+ * the failed expectations, or telling that the test did not check
+ * any assertion if #ASSERTS is set, and the test metrics.
+ *
+ * @param expected The test.
+ * @param result The test results.
+ * @return @c true if at least one expectation failed, or no
+ * assertion was checked with #ASSERTS set, @c false otherwise.
+ */
+static bool sccroll_diffAsserts(const SccrollEffects* restrict expected, const SccrollResult* restrict result)
     __attribute__((nonnull));
 
+/**
+ * @since 0.1.0
+ * @brief Print a failed assertion record on stderr, prefixed by its
+ * location if it has one.
+ * @param record The record.
+ */
+static void sccroll_precord(const SccrollRecord* restrict record) __attribute__((nonnull));
+
 /**
  * @since 0.1.0
  * @brief Compare two SccrollEffects::std.
@@ -488,7 +1248,7 @@ static bool sccroll_diffCodes(const SccrollEffects* restrict expected, const Scc
  * @return @c true if any of the @p expected and @p results
  * SccrollEffects::std::content are different, @c false otherwise.
  */
-static bool sccroll_diffStd(const SccrollEffects* restrict expected, const SccrollEffects* restrict result)
+static bool sccroll_diffStd(const SccrollEffects* restrict expected, const SccrollResult* restrict result)
     __attribute__((nonnull));
 
 
@@ -503,9 +1263,35 @@ static bool sccroll_diffStd(const SccrollEffects* restrict expected, const Sccro
  * @return @c true if any of the @p expected and @p results
  * SccrollEffects::files::content are different, @c false otherwise.
  */
-static bool sccroll_diffFiles(const SccrollEffects* restrict expected, const SccrollEffects* restrict result)
+static bool sccroll_diffFiles(const SccrollEffects* restrict expected, const SccrollResult* restrict result)
+    __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Compare a hashed SccrollEffects::files.
+ *
+ * If #NODIFF is **not** defined, the function print a report if the
+ * digests or sizes differ. If the file has a reference, the report
+ * also dumps the bytes around the first difference of both files,
+ * read by chunks.
+ *
+ * @param expected The expected effects.
+ * @param result The obtained effects.
+ * @param index The file index.
+ * @return @c true if the files are different, @c false otherwise.
+ */
+static bool sccroll_diffHash(const SccrollEffects* restrict expected, const SccrollResult* restrict result, int index)
     __attribute__((nonnull));
 
+/**
+ * @since 0.1.0
+ * @brief Search the first different byte of two streams, read by
+ * chunks.
+ * @param streams The streams to compare.
+ * @return The offset of the first different byte.
+ */
+static off_t sccroll_foffset(FILE* streams[2]) __attribute__((nonnull));
+
 /**
  * @since 0.1.0
  * @brief Print an error message describing the difference between the
@@ -513,7 +1299,7 @@ static bool sccroll_diffFiles(const SccrollEffects* restrict expected, const Scc
  * @param expected The expected effects.
  * @param result The obtained effects.
  */
-static void sccroll_pcodes(const SccrollEffects* restrict expected, const SccrollEffects* restrict result)
+static void sccroll_pcodes(const SccrollEffects* restrict expected, const SccrollResult* restrict result)
     __attribute__((nonnull));
 
 /**
@@ -553,6 +1339,225 @@ static void sccroll_dump(const SccrollBlobDiff* restrict infos) __attribute__((n
  */
 static void sccroll_review(int report[REPORTMAX]) __attribute__((nonnull));
 
+// clang-format off
+
+/******************************************************************************
+ * @}
+ *
+ * @name Files trees comparison
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @enum SccrollTreeStatus
+ * @since 0.1.0
+ * @brief Comparison status of a file of two trees.
+ */
+typedef enum SccrollTreeStatus {
+    TREESAME,    /**< The file is the same in both trees. */
+    TREEMISSING, /**< The file is only in the expected tree. */
+    TREEEXTRA,   /**< The file is only in the obtained tree. */
+    TREEDIFF,    /**< The file contents differ. */
+} SccrollTreeStatus;
+
+/**
+ * @enum SccrollTreeSizes
+ * @since 0.1.0
+ * @brief Trees comparison constants.
+ */
+typedef enum SccrollTreeSizes {
+    TREEWORKERS = 64, /**< Max number of comparison threads. */
+} SccrollTreeSizes;
+
+/**
+ * @struct SccrollTreeFile
+ * @since 0.1.0
+ * @brief A file of two compared trees.
+ */
+typedef struct SccrollTreeFile {
+    char* path;               /**< The file path relative to the trees roots. */
+    SccrollTreeStatus status; /**< The comparison status. */
+    off_t expsize;            /**< The expected file byte size. */
+    off_t ressize;            /**< The obtained file byte size. */
+    off_t offset;             /**< The offset of the first different byte. */
+} SccrollTreeFile;
+
+/**
+ * @struct SccrollTree
+ * @since 0.1.0
+ * @brief Two trees comparison state, shared by the workers.
+ */
+typedef struct SccrollTree {
+    const char* expected;   /**< The expected tree root. */
+    const char* result;     /**< The obtained tree root. */
+    const char* name;       /**< The test name. */
+    SccrollTreeFile* files; /**< The union of both trees files, sorted. */
+    size_t len;             /**< The number of files. */
+    size_t next;            /**< The index of the next file to compare. */
+} SccrollTree;
+
+/**
+ * @def TREEFMT
+ * @since 0.1.0
+ * @brief Tree file status format string.
+ * @param s The status description.
+ * @param i A SccrollFonts code.
+ * @param i A SccrollColors code.
+ * @param s The file path.
+ */
+#define TREEFMT "%s: " COLSTRFMT
+
+/**
+ * @def SIZESFMT
+ * @since 0.1.0
+ * @brief Tree file sizes mismatch format string.
+ * @param jd The expected size.
+ * @param jd The obtained size.
+ */
+#define SIZESFMT " [%jd != %jd bytes]\n"
+
+/**
+ * @def OFFSETFMT
+ * @since 0.1.0
+ * @brief Tree file first different byte format string.
+ * @param jd The byte offset.
+ */
+#define OFFSETFMT " [byte %jd]\n"
+
+/**
+ * @since 0.1.0
+ * @brief Compare a tree SccrollEffects::files.
+ *
+ * If #NODIFF is **not** defined, the function print a report listing
+ * the missing, extra and different files.
+ *
+ * @param expected The expected effects.
+ * @param index The file index.
+ * @return @c true if the trees are different, @c false otherwise.
+ */
+static bool sccroll_diffTree(const SccrollEffects* restrict expected, int index)
+    __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief List the regular files of both trees.
+ * @param tree The comparison state, whose SccrollTree::files and
+ * SccrollTree::len are set.
+ */
+static void sccroll_treeList(SccrollTree* restrict tree) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Add the regular files paths of a directory, recursively, to
+ * an argz vector.
+ * @param root The tree root.
+ * @param dir The directory path relative to @p root, or @c NULL for
+ * the root itself.
+ * @param argz,len The argz vector.
+ */
+static void sccroll_treeWalk(const char* restrict root, const char* restrict dir, char** argz, size_t* len)
+    __attribute__((nonnull(1, 3, 4)));
+
+/**
+ * @since 0.1.0
+ * @brief Extract and sort the paths of an argz vector.
+ * @param argz,len The argz vector.
+ * @param count The number of paths.
+ * @return A malloc'ed array of @p count paths pointing in @p argz,
+ * sorted.
+ */
+static char** sccroll_treeSort(char* argz, size_t len, size_t count);
+
+/**
+ * @since 0.1.0
+ * @brief qsort() strings comparison function.
+ * @param a,b Pointers to the strings to compare.
+ * @return The strcmp() of the strings.
+ */
+static int sccroll_treeCmp(const void* a, const void* b) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Compare the files of two trees, until none is left.
+ * @param tree The comparison state.
+ * @return @c NULL.
+ */
+static void* sccroll_treeWorker(void* tree) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Compare a file present in both trees.
+ * @param tree The comparison state.
+ * @param file The file to compare.
+ */
+static void sccroll_treeCompare(const SccrollTree* restrict tree, SccrollTreeFile* restrict file)
+    __attribute__((nonnull));
+
+// clang-format off
+
+/******************************************************************************
+ * @}
+ *
+ * @name Expectations update
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @since 0.1.0
+ * @brief Replace the on-disk standard outputs expectations by the
+ * obtained outputs.
+ *
+ * Only the SccrollEffects::std given by path, and the
+ * SccrollEffects::files::ref of the hashed files, different from the
+ * obtained ones, are rewritten. The @p expected contents and digests
+ * are replaced too, in order for the following comparison to pass;
+ * the new digests are reported, as they are not stored on disk. The
+ * outputs which filled their capture buffer may be truncated, and
+ * are not written.
+ *
+ * @param expected The expected effects.
+ * @param result The obtained effects.
+ */
+static void sccroll_update(SccrollEffects* restrict expected, const SccrollResult* restrict result)
+    __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Replace a reference tree file by the obtained one, or
+ * remove it if it is missing from the obtained tree.
+ * @param tree The comparison state.
+ * @param file The file to update.
+ */
+static void sccroll_treeUpdate(const SccrollTree* restrict tree, const SccrollTreeFile* restrict file)
+    __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Atomically replace the content of a file.
+ *
+ * The content is written in a temporary file of the same directory,
+ * renamed to @p path once complete. The missing parent directories
+ * are created.
+ *
+ * @param path The file path.
+ * @param source The stream to copy, or @c NULL.
+ * @param blob The bytes to write if @p source is @c NULL.
+ * @param size The byte size of @p blob.
+ * @param name The test name.
+ */
+static void sccroll_fsave(const char* restrict path, FILE* restrict source, const void* restrict blob, size_t size, const char* restrict name)
+    __attribute__((nonnull(1, 5)));
+
+/**
+ * @since 0.1.0
+ * @brief Create the missing parent directories of a path.
+ * @param path The path.
+ * @param name The test name.
+ */
+static void sccroll_mkdirs(const char* restrict path, const char* restrict name) __attribute__((nonnull));
+
 // clang-format off
 
 /******************************************************************************
@@ -570,12 +1575,14 @@ static void sccroll_review(int report[REPORTMAX]) __attribute__((nonnull));
  * The freed items are:
  * - all SccrollEffects::files::content::blob up to the first @c NULL
  *   SccrollEffects::files::path
- * - all SccrollEffects::std::content::blob
+ * - all SccrollEffects::std::content::blob not given by path (these
+ *   are loaded in the test #arena)
  * - @p effects
  * @param effects The struct to free.
  */
 static void sccroll_free(const SccrollEffects* restrict effects) __attribute__((nonnull));
 
+
 /**
  * @since 0.1.0
  * @brief Cleanup the library at exit.
@@ -619,16 +1626,66 @@ void sccroll_register(const SccrollEffects* restrict expected)
     tests = lpush(sccroll_prepare(expected), tests);
 }
 
+void sccroll_fixture(const SccrollFixture* restrict fixture)
+{
+    SccrollFixture* copy = blobdup(fixture, sizeof(SccrollFixture));
+    sccroll_err(!copy, "alloc", fixture->name);
+    fixtures = lpush(copy, fixtures);
+}
+
+static const SccrollFixture* sccroll_fixtureFind(const SccrollEffects* restrict expected)
+{
+    Node* node = fixtures ? fixtures->head : NULL;
+    for (; node; node = node->next)
+        if (!strcmp(((SccrollFixture*)node->data)->name, expected->fixture))
+            return node->data;
+    sccroll_err(true, "fixture lookup", expected->name);
+    return NULL;
+}
+
+void sccroll_suite(const SccrollSuite* restrict suite)
+{
+    SccrollSuite* copy = blobdup(suite, sizeof(SccrollSuite));
+    sccroll_err(!copy, "alloc", suite->name);
+    suites = lpush(copy, suites);
+}
+
+static const SccrollSuite* sccroll_suiteFind(const char* restrict name)
+{
+    Node* node = suites && name ? suites->head : NULL;
+    for (; node; node = node->next)
+        if (!strcmp(((SccrollSuite*)node->data)->name, name))
+            return node->data;
+    return NULL;
+}
+
+static List* sccroll_gather(SccrollEffects* restrict first, List* restrict queue, size_t field)
+{
+    const char* name  = *(const char**)((char*)first + field);
+    const char* other = NULL;
+    List* group       = lpush(first, NULL);
+    for (int i = 0; i < queue->len;) {
+        other = *(const char**)((char*)lidx(i, queue)->data + field);
+        if (other == name || (other && name && !strcmp(other, name)))
+            group = lappend(lpopidx(i, queue), group);
+        else ++i;
+    }
+    return group;
+}
+
 static SccrollEffects* sccroll_prepare(const SccrollEffects* restrict effects)
 {
     SccrollEffects* prepared = sccroll_dup(effects);
     int i;
     char *stripped;
     for (i = STDIN_FILENO; i < SCCMAXSTD; ++i)
-        if (!sccroll_hasFlags(prepared->flags, NOSTRP)) {
+        // The contents given by path are stripped once loaded.
+        if (!sccroll_hasFlags(prepared->flags, NOSTRP) && prepared->std[i].content.blob) {
             stripped = sccroll_strip(prepared->std[i].content.blob);
             free(prepared->std[i].content.blob);
             prepared->std[i].content.blob = stripped;
+            // The stripped content is now a string.
+            prepared->std[i].content.size = 0;
         }
 
     return prepared;
@@ -641,22 +1698,50 @@ static SccrollEffects* sccroll_dup(const SccrollEffects* restrict effects)
     copy->wrapper = effects->wrapper;
     copy->flags   = effects->flags;
     copy->code    = effects->code;
+    copy->fixture = effects->fixture;
+    copy->suite   = effects->suite;
+    copy->limits  = effects->limits;
 
     for (int i = 0; i < SCCMAX && (effects->files[i].path || i < SCCMAXSTD); ++i) {
-        if (i < SCCMAXSTD) {
-            if ((copy->std[i].path = effects->std[i].path))
-                sccroll_fread(&copy->std[i], effects->name);
+        if (i < SCCMAXSTD && !(copy->std[i].path = effects->std[i].path))
+            sccroll_blobcpy(&copy->std[i].content, &effects->std[i].content);
+
+        if ((copy->files[i].path = effects->files[i].path)) {
+            copy->files[i].hash = effects->files[i].hash;
+            copy->files[i].ref  = effects->files[i].ref;
+            copy->files[i].tree = effects->files[i].tree;
+            // Hashed contents and trees are never loaded.
+            if (copy->files[i].hash || copy->files[i].tree)
+                copy->files[i].content.size = effects->files[i].content.size;
             else
-                sccroll_blobcpy(&copy->std[i].content, &effects->std[i].content);
+                sccroll_blobcpy(&copy->files[i].content, &effects->files[i].content);
         }
-
-        if ((copy->files[i].path = effects->files[i].path))
-            sccroll_blobcpy(&copy->files[i].content, &effects->files[i].content);
     }
 
     return copy;
 }
 
+static void sccroll_load(SccrollEffects* restrict effects)
+{
+    for (int i = STDIN_FILENO; i < SCCMAXSTD; ++i) {
+        if (!effects->std[i].path || effects->std[i].content.blob) continue;
+        sccroll_fread(effects->std[i].path, &effects->std[i].content, effects->name);
+        if (!sccroll_hasFlags(effects->flags, NOSTRP)) {
+            effects->std[i].content.blob = sccroll_trim(effects->std[i].content.blob);
+            effects->std[i].content.size = 0;
+        }
+    }
+}
+
+static SccrollResult* sccroll_result(const SccrollEffects* restrict expected)
+{
+    size_t len = 0;
+    while (len < SCCMAX && expected->files[len].path) ++len;
+    SccrollResult* result = sccroll_adup(NULL, sizeof(SccrollResult) + len * sizeof(Data), expected->name);
+    result->len = len;
+    return result;
+}
+
 static SccrollEffects* sccroll_gen(void)
 {
     SccrollEffects* effects = calloc(1, sizeof(SccrollEffects));
@@ -685,109 +1770,459 @@ static char* sccroll_strip(const char* oldstring)
     return string;
 }
 
-static void sccroll_fread(SccrollFile* restrict file, const char* restrict name)
+static char* sccroll_trim(char* string)
+{
+    char* end = string + strlen(string);
+    while (isspace(*string)) ++string;
+    while (end > string && isspace(*(end - 1))) --end;
+    *end = 0;
+    return string;
+}
+
+static void* sccroll_adup(const void* restrict blob, size_t size, const char* restrict name)
+{
+    void* copy = sccroll_arenaDup(&arena, blob, size);
+    sccroll_err(!copy, "alloc", name);
+    return copy;
+}
+
+static void sccroll_fhash(const char* restrict path, Data* restrict content, const char* restrict name)
+{
+    char hex[SCCHASHHEX] = { 0 };
+    long long size = 0;
+    FILE* stream = fopen(path, "rb");
+    sccroll_err(!stream, path, name);
+    sccroll_err((size = sccroll_hashFile(stream, hex)) < 0, path, name);
+    fclose(stream);
+    content->blob = sccroll_adup(hex, strlen(hex), name);
+    content->size = size;
+}
+
+static void sccroll_fread(const char* restrict path, Data* restrict content, const char* restrict name)
+{
+    char buffer[SCCMAX] = { 0 };
+    FILE* stream = fopen(path, "rb");
+    sccroll_err(!stream, path, name);
+    sccroll_err(
+        !(content->size = fread(buffer, sizeof(char), SCCMAX, stream))
+        && ferror(stream), path, name
+    );
+    fclose(stream);
+    // The copy is followed by a null byte, to take account of strings
+    // comparisons. Since size is not modified, it is hidden to the
+    // blobs comparisons.
+    content->blob = sccroll_adup(buffer, content->size, name);
+}
+
+// clang-format off
+
+/******************************************************************************
+ * Execution
+ ******************************************************************************/
+// clang-format on
+
+// The predefined main is a weak alias to allow any defined override.
+weak_alias(, sccroll_main, main);
+static int sccroll_main(void)
+{
+    return sccroll_run() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int sccroll_run(void)
+{
+    if (!tests) return 0;
+
+    setbuf(stdout, NULL);
+
+    int report[REPORTMAX] = { 0 };
+    report[REPORTTOTAL]   = tests->len;
+    const char* env       = getenv(SCCUPDATE);
+    update                = env && *env && strcmp(env, "0");
+    env                   = getenv(SCCWORKERS);
+    workers               = env && *env && strcmp(env, "0");
+    env                   = getenv(SCCPROFILE);
+    // The timings are shared with the forked tests processes.
+    if (env && *env && strcmp(env, "0")) {
+        profile = mmap(NULL, sizeof(SccrollProfile), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        sccroll_err(profile == MAP_FAILED, "mmap", "the profiling");
+        memset(profile, 0, sizeof(SccrollProfile));
+    }
+    env = getenv(SCCTRACE);
+    if (env && *env) sccroll_traceOpen(env);
+
+    const char* filter = getenv(SCCSUITES);
+    List* group        = NULL;
+    sccroll_init();
+    while (tests->len) {
+        group = sccroll_gather(lpop(tests), tests, offsetof(SccrollEffects, suite));
+        if (sccroll_selected(filter, ((SccrollEffects*)group->head->data)->suite))
+            report[REPORTFAIL] += sccroll_suiteRun(group);
+        else {
+            report[REPORTTOTAL] -= group->len;
+            sccroll_lfree(group);
+        }
+    }
+    sccroll_review(report);
+    if (profile) {
+        sccroll_profile();
+        munmap(profile, sizeof(SccrollProfile));
+        profile = NULL;
+    }
+    if (tracefd >= 0) sccroll_traceClose();
+    sccroll_clean();
+
+    lfree(tests);
+    tests = NULL;
+    return report[REPORTFAIL];
+}
+
+SccrollCode sccroll_exec(const SccrollEffects* restrict effects)
+{
+    // The execution may happen during a test, whose allocations must
+    // be kept.
+    SccrollArena saved = arena;
+    arena = (SccrollArena){ 0 };
+    SccrollEffects* expected = sccroll_prepare(effects);
+    sccroll_load(expected);
+    SccrollResult* result = sccroll_exe(expected);
+    SccrollCode code = { .type = expected->code.type, .value = result->code };
+    sccroll_free(expected);
+    sccroll_arenaFree(&arena);
+    arena = saved;
+    return code;
+}
+
+void* sccroll_scratch(size_t size)
+{
+    return sccroll_arenaAlloc(&arena, size);
+}
+
+static int sccroll_test(SccrollEffects* restrict expected)
+{
+    uint64_t start = sccroll_clock();
+    uint64_t clock = start;
+    sccroll_load(expected);
+    sccroll_phase(PHASELOAD, clock);
+    SccrollResult* result = sccroll_exe(expected);
+    clock = sccroll_clock();
+    // The effects of a test stopped by its limits are truncated.
+    if (update && !result->limit) sccroll_update(expected, result);
+    int failed = sccroll_diff(expected, result);
+    if (failed) {
+        fprintf(stderr, BASEFMT "\n", BOLD, RED, "FAIL", expected->name);
+        if (!sccroll_hasFlags(expected->flags, NODIFF)) fprintf(stderr, "\n");
+    }
+    sccroll_phase(PHASEDIFF, clock);
+    if (tracefd >= 0) sccroll_traceTest(expected, result, failed, start);
+    sccroll_free(expected);
+    sccroll_arenaReset(&arena);
+    return failed;
+}
+
+static bool sccroll_selected(const char* restrict filter, const char* restrict name)
+{
+    if (!filter || !*filter) return true;
+    if (!name) return false;
+
+    size_t len = strlen(name);
+    for (const char* next = filter; next; next = strchr(next, ',')) {
+        if (*next == ',') ++next;
+        if (!strncmp(next, name, len) && (!next[len] || next[len] == ',')) return true;
+    }
+    return false;
+}
+
+static int sccroll_suiteRun(List* restrict group)
+{
+    const SccrollSuite* suite = sccroll_suiteFind(((SccrollEffects*)group->head->data)->suite);
+    if (suite && suite->init) suite->init();
+    int failed = sccroll_schedule(group, suite);
+    if (suite && suite->clean) suite->clean();
+    return failed;
+}
+
+static int sccroll_schedule(List* restrict queue, const SccrollSuite* restrict suite)
+{
+    SccrollPool pool         = { .suite = suite };
+    SccrollEffects* expected = NULL;
+    List* units              = NULL;
+    int jobs                 = suite ? suite->jobs : 0;
+    int failed               = 0;
+    int status               = 0;
+
+    while (queue->len) {
+        expected = lpop(queue);
+        units = lappend(
+            expected->fixture
+            ? sccroll_gather(expected, queue, offsetof(SccrollEffects, fixture))
+            : lpush(expected, NULL),
+            units
+        );
+    }
+    lfree(queue);
+
+    if (suite && suite->cpus && (jobs < 0 || jobs > 1)) pool.ncpus = sccroll_cpus(suite, pool.cpus);
+    if (jobs < 0) jobs = pool.ncpus ? pool.ncpus : sysconf(_SC_NPROCESSORS_ONLN);
+    if (jobs <= 1 || units->len <= 1) {
+        while (units->len) failed += sccroll_unit(lpop(units));
+        lfree(units);
+        return failed;
+    }
+    if (jobs > units->len) jobs = units->len;
+
+    // The units results are shared with the workers, and stay at -1
+    // for the units whose worker did not end normally.
+    size_t size = sizeof(size_t) + units->len * sizeof(int);
+    size_t* next = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    sccroll_err(next == MAP_FAILED, "mmap", "the workers results");
+    int* results = (int*)(next + 1);
+    memset(results, -1, units->len * sizeof(int));
+    pool.units   = units;
+    pool.next    = next;
+    pool.results = results;
+
+    for (int i = 0; i < jobs; ++i) {
+        fflush(stderr);
+        pid_t pid = fork();
+        sccroll_err(pid < 0, "fork", suite->name);
+        if (!pid) sccroll_worker(&pool, i);
+    }
+    while (wait(&status) > 0);
+
+    for (int i = 0; units->len; ++i) {
+        List* unit = lpop(units);
+        failed += results[i] < 0 ? unit->len : results[i];
+        sccroll_lfree(unit);
+    }
+    lfree(units);
+    munmap(next, size);
+    return failed;
+}
+
+static void sccroll_worker(const SccrollPool* restrict pool, int index)
+{
+    static char buffer[SUITEBUFFER];
+    struct timespec start  = { 0 };
+    struct timespec end    = { 0 };
+    struct rusage usage[2] = { 0 };
+    char cpu[SCCMAX]       = "any";
+    int units              = 0;
+    double busy            = 0;
+    double wall            = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (pool->ncpus) {
+        sprintf(cpu, "%i", pool->cpus[index % pool->ncpus]);
+        sccroll_pin(pool->suite, pool->cpus[index % pool->ncpus]);
+    }
+    if (tracefd >= 0) {
+        char name[TRACENAME] = { 0 };
+        snprintf(name, TRACENAME, "%.*s worker %i (CPU %.*s)", TRACENAME / 2, pool->suite->name, index, TRACENAME / 4, cpu);
+        lane = index + 1;
+        sccroll_traceLane(name);
+    }
+
+    // The reports are printed at once at the end of each unit, to not
+    // interleave with the other workers ones.
+    setvbuf(stderr, buffer, _IOFBF, SUITEBUFFER);
+    for (size_t unit; (unit = __atomic_fetch_add(pool->next, 1, __ATOMIC_RELAXED)) < (size_t)pool->units->len; ++units) {
+        pool->results[unit] = sccroll_unit(lidx(unit, pool->units)->data);
+        fflush(stderr);
+    }
+
+    if (workers) {
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        // The tests run in child processes, all reaped by now.
+        getrusage(RUSAGE_SELF, &usage[0]);
+        getrusage(RUSAGE_CHILDREN, &usage[1]);
+        for (int i = 0; i < 2; ++i)
+            busy += usage[i].ru_utime.tv_sec + usage[i].ru_stime.tv_sec
+                + (usage[i].ru_utime.tv_usec + usage[i].ru_stime.tv_usec) / 1e6;
+        wall = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        fprintf(stderr, WORKERFMT, pool->suite->name, index, cpu, units, busy, wall, wall > 0 ? 100 * busy / wall : 0);
+    }
+    // The user supplied buffer is not flushed by exit().
+    fflush(stderr);
+    exit(EXIT_SUCCESS);
+}
+
+static int sccroll_cpus(const SccrollSuite* restrict suite, int cpus[CPU_SETSIZE])
 {
-    char buffer[SCCMAX] = { 0 };
-    FILE* stream = fopen(file->path, "rb");
-    sccroll_err(!stream, file->path, name);
-    sccroll_err(
-        !(file->content.size = fread(buffer, sizeof(char), SCCMAX, stream))
-        && ferror(stream), file->path, name
-    );
-    fclose(stream);
-    // +char to take account of strings comparisons. Since size is not
-    // modified, the last byte is null and is hidden to the
-    // comparison.
-    file->content.blob = blobdup(
-        buffer,
-        file->content.size < sizeof(buffer)
-        ? file->content.size+sizeof(char)
-        : sizeof(buffer)
-    );
-}
+    cpu_set_t set    = { 0 };
+    const char* list = suite->cpus;
+    char* end        = NULL;
+    long first       = 0;
+    long last        = 0;
+    int count        = 0;
+
+    CPU_ZERO(&set);
+    if (!*list) sccroll_err(sched_getaffinity(0, sizeof(set), &set) < 0, "sched_getaffinity", suite->name);
+    while (*list) {
+        first = last = strtol(list, &end, 10);
+        if (end != list && *end == '-' && isdigit(end[1])) last = strtol(end + 1, &end, 10);
+        sccroll_err(end == list || first < 0 || last < first || last >= CPU_SETSIZE || (*end && *end != ','), "CPUs list parsing", suite->name);
+        while (first <= last) CPU_SET(first++, &set);
+        list = *end ? end + 1 : end;
+    }
 
-// clang-format off
-
-/******************************************************************************
- * Execution
- ******************************************************************************/
-// clang-format on
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        if (CPU_ISSET(cpu, &set)) cpus[count++] = cpu;
+    sccroll_err(!count, "CPUs list parsing", suite->name);
+    return count;
+}
 
-// The predefined main is a weak alias to allow any defined override.
-weak_alias(, sccroll_main, main);
-static int sccroll_main(void)
+static void sccroll_pin(const SccrollSuite* restrict suite, int cpu)
 {
-    return sccroll_run() ? EXIT_FAILURE : EXIT_SUCCESS;
+    cpu_set_t set      = { 0 };
+    int node           = suite->numa ? sccroll_node(cpu) : -1;
+    unsigned long mask = 0;
+
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sccroll_err(sched_setaffinity(0, sizeof(set), &set) < 0, "sched_setaffinity", suite->name);
+
+    // The binding is a best effort, as the kernel may lack the NUMA
+    // support.
+    if (node < 0 || node >= (int)(sizeof(mask) * CHAR_BIT)) return;
+    mask = 1UL << node;
+    syscall(SYS_set_mempolicy, MPOL_BIND, &mask, sizeof(mask) * CHAR_BIT);
 }
 
-int sccroll_run(void)
+static int sccroll_node(int cpu)
 {
-    if (!tests) return 0;
+    char path[PATH_MAX]  = { 0 };
+    struct dirent* entry = NULL;
+    int node             = -1;
+
+    sprintf(path, "/sys/devices/system/cpu/cpu%i", cpu);
+    DIR* dir = opendir(path);
+    while (dir && node < 0 && (entry = readdir(dir)))
+        if (sscanf(entry->d_name, "node%i", &node) != 1) node = -1;
+    if (dir) closedir(dir);
+    return node;
+}
 
-    setbuf(stdout, NULL);
+static int sccroll_unit(List* restrict unit)
+{
+    if (((SccrollEffects*)unit->head->data)->fixture) return sccroll_group(unit);
 
-    int report[REPORTMAX] = { 0 };
-    report[REPORTTOTAL]   = tests->len;
+    sccroll_before();
+    int failed = sccroll_test(lpop(unit));
+    sccroll_after();
+    lfree(unit);
+    return failed;
+}
 
-    sccroll_init();
-    while (tests->len) {
-        sccroll_before();
-        report[REPORTFAIL] += sccroll_test();
-        sccroll_after();
+static int sccroll_group(List* restrict group)
+{
+    const SccrollFixture* fixture = sccroll_fixtureFind(group->head->data);
+    int failed                    = -1;
+    int status                    = 0;
+    int pipefd[2]                 = { 0 };
+
+    sccroll_pipes(PIPEOPEN, fixture->name, pipefd);
+    fflush(stderr);
+    pid_t pid = fork();
+    sccroll_err(pid < 0, "fork", fixture->name);
+    if (pid == 0) {
+        sccroll_pipes(PIPECLOSE, fixture->name, pipefd, PIPEREAD);
+        fixture->setup();
+        for (failed = 0; group->len;) {
+            sccroll_before();
+            failed += sccroll_test(lpop(group));
+            sccroll_after();
+        }
+        if (fixture->teardown) fixture->teardown();
+        sccroll_pipes(PIPEWRTE, fixture->name, pipefd, &failed, sizeof(int));
+        // The reports may be buffered by a suite worker.
+        fflush(stderr);
+        exit(EXIT_SUCCESS);
     }
-    sccroll_review(report);
-    sccroll_clean();
 
-    lfree(tests);
-    tests = NULL;
-    return report[REPORTFAIL];
+    sccroll_pipes(PIPECLOSE, fixture->name, pipefd, PIPEWRTE);
+    sccroll_err(waitpid(pid, &status, 0) < 0, "wait", fixture->name);
+    // Nothing is received if the fixture process ended early.
+    sccroll_pipes(PIPEREAD, fixture->name, pipefd, &failed, sizeof(int));
+    if (failed < 0 || !WIFEXITED(status) || WEXITSTATUS(status)) {
+        fprintf(stderr, FIXTUREFMT, fixture->name, group->len);
+        failed = group->len;
+    }
+    sccroll_pipes(PIPECLOSE, fixture->name, pipefd, PIPEREAD);
+    sccroll_lfree(group);
+    return failed;
 }
 
-static int sccroll_test(void)
+static void sccroll_lfree(List* restrict list)
 {
-    const SccrollEffects* expected = lpop(tests);
-    const SccrollEffects* result   = sccroll_exe(sccroll_dup(expected));
-    int failed = sccroll_diff(expected, result);
-    if (failed) {
-        fprintf(stderr, BASEFMT "\n", BOLD, RED, "FAIL", expected->name);
-        if (!sccroll_hasFlags(expected->flags, NODIFF)) fprintf(stderr, "\n");
-    }
-    sccroll_free(expected);
-    sccroll_free(result);
-    return failed;
+    while (list->len) sccroll_free(lpop(list));
+    lfree(list);
 }
 
-static const SccrollEffects* sccroll_exe(SccrollEffects* restrict result)
+static SccrollResult* sccroll_exe(const SccrollEffects* restrict expected)
 {
-    bool dofork              = !sccroll_hasFlags(result->flags, NOFORK);
+    SccrollResult* result    = sccroll_result(expected);
+    bool dofork              = !sccroll_hasFlags(expected->flags, NOFORK);
     size_t length            = 0;
     int status               = 0;
     int origstd[SCCMAXSTD]   = { 0 };
     int pipefd[PIPEMAXFD][2] = { 0 };
+    char leaf[PATH_MAX]      = { 0 };
+    uint64_t clock           = sccroll_clock();
 
-    for (int i = STDIN_FILENO; i < PIPEMAXFD; ++i)
-        sccroll_pipes(PIPEOPEN, result->name, pipefd[i]);
+    for (int i = STDIN_FILENO; i < PIPEASRT; ++i)
+        sccroll_pipes(PIPEOPEN, expected->name, pipefd[i]);
+    sccroll_pipes(PIPEMEMFD, expected->name, pipefd[PIPEASRT]);
+    if (dofork) sccroll_cgroupOpen(expected, leaf);
+    clock = sccroll_phase(PHASEPIPES, clock);
 
+    // Pending reports must not be duplicated in the fork.
+    if (dofork) fflush(stderr);
     pid_t pid = dofork ? fork() : 0;
-    sccroll_err(pid < 0, "fork", result->name);
+    sccroll_err(pid < 0, "fork", expected->name);
+    result->pid = dofork ? pid : getpid();
+    if (dofork && pid) clock = sccroll_phase(PHASEFORK, clock);
     if (pid == 0) {
+        if (dofork) setvbuf(stderr, NULL, _IONBF, 0);
         for (int i = STDIN_FILENO, p = PIPEREAD; i < SCCMAXSTD; ++i, p = PIPEWRTE) {
-            if (!dofork) sccroll_err((origstd[i] = dup(i)) < 0, "dup save of standard", result->name);
-            sccroll_pipes(PIPEDUP, result->name, pipefd[i], p, i);
+            if (!dofork) sccroll_err((origstd[i] = dup(i)) < 0, "dup save of standard", expected->name);
+            sccroll_pipes(PIPEDUP, expected->name, pipefd[i], p, i);
         }
 
+        if (dofork) sccroll_limit(expected, leaf);
+        // The trace is not part of the test output.
+        if (dofork && expected->limits.output) tracefd = -1;
         errno = 0;
-        length = sizeof(char)*strlen(result->std[STDIN_FILENO].content.blob);
-        sccroll_pipes(PIPEWRTE, result->name, pipefd[STDIN_FILENO], result->std[STDIN_FILENO].content.blob, length);
-        result->wrapper();
-        sccroll_pipes(PIPEWRTE, result->name, pipefd[PIPEERRN], &errno, sizeof(int));
+        clock = sccroll_clock();
+        length = expected->std[STDIN_FILENO].content.size
+            ? expected->std[STDIN_FILENO].content.size
+            : sizeof(char)*strlen(expected->std[STDIN_FILENO].content.blob);
+        sccroll_pipes(PIPEWRTE, expected->name, pipefd[STDIN_FILENO], expected->std[STDIN_FILENO].content.blob, length);
+        clock = sccroll_phase(PHASESTDIN, clock);
+        // The assertions of the test are counted apart from the ones
+        // of the runner, for the tests not forked.
+        unsigned long asserts = sccroll_asserts;
+        sccroll_asserts = 0;
+        // The failed assertions and crashes of a forked test are
+        // sent to the runner, not printed.
+        if (dofork) {
+            sccroll_channel(pipefd[PIPEASRT][PIPEWRTE]);
+            sccroll_forensics(expected);
+        }
+        expected->wrapper();
+        // The virtual clock does not outlive its test.
+        sccroll_mockClock(false);
+        clock = sccroll_phase(PHASETEST, clock);
+        sccroll_pipes(PIPEWRTE, expected->name, pipefd[PIPEERRN], &errno, sizeof(int));
+        sccroll_assertsSend(expected, pipefd[PIPEASRT]);
+        sccroll_channel(-1);
+        sccroll_asserts += asserts;
 
         for (int i = STDIN_FILENO, p = PIPEREAD; i < SCCMAXSTD; ++i, p = PIPEWRTE) {
             if (!dofork) {
-                sccroll_err(dup2(origstd[i], i) < 0, "original std fd restoration", result->name);
-                sccroll_err(close(origstd[i]) < 0, "could not close original std fd", result->name);
+                sccroll_err(dup2(origstd[i], i) < 0, "original std fd restoration", expected->name);
+                sccroll_err(close(origstd[i]) < 0, "could not close original std fd", expected->name);
             }
-            sccroll_pipes(PIPECLOSE, result->name, pipefd[i], p);
+            sccroll_pipes(PIPECLOSE, expected->name, pipefd[i], p);
         }
 
         if (dofork) exit(EXIT_SUCCESS);
@@ -795,17 +2230,23 @@ static const SccrollEffects* sccroll_exe(SccrollEffects* restrict result)
 
     if (dofork) {
         for (int i = STDIN_FILENO; i < PIPEMAXFD; ++i)
-            sccroll_pipes(PIPECLOSE, result->name, pipefd[i], PIPEWRTE);
-        sccroll_pipes(PIPECLOSE, result->name, pipefd[STDIN_FILENO], PIPEREAD);
-        wait(&status);
+            sccroll_pipes(PIPECLOSE, expected->name, pipefd[i], PIPEWRTE);
+        sccroll_pipes(PIPECLOSE, expected->name, pipefd[STDIN_FILENO], PIPEREAD);
+        wait4(pid, &status, 0, &result->usage);
+        clock = sccroll_phase(PHASEWAIT, clock);
+        result->limit = sccroll_breach(expected, status, &result->usage, leaf);
     }
-    sccroll_codes(result, pipefd[PIPEERRN], status);
-    sccroll_std(result, pipefd);
-    sccroll_files(result);
+    clock = sccroll_clock();
+    sccroll_codes(expected, result, pipefd[PIPEERRN], status);
+    sccroll_std(expected, result, pipefd);
+    sccroll_assertsRecv(expected, result, pipefd[PIPEASRT]);
+    clock = sccroll_phase(PHASECAPTURE, clock);
+    sccroll_files(expected, result);
+    sccroll_phase(PHASEFILES, clock);
 
     for (int i = STDIN_FILENO; i < PIPEMAXFD; ++i) {
-        sccroll_pipes(PIPECLOSE, result->name, pipefd[i], PIPEREAD);
-        sccroll_pipes(PIPECLOSE, result->name, pipefd[i], PIPEWRTE);
+        sccroll_pipes(PIPECLOSE, expected->name, pipefd[i], PIPEREAD);
+        sccroll_pipes(PIPECLOSE, expected->name, pipefd[i], PIPEWRTE);
     }
     return result;
 }
@@ -819,6 +2260,12 @@ static void sccroll_pipes(SccrollPipes type, const char* restrict name, int pipe
     va_start(args, pipefd);
     switch (type) {
     case PIPEOPEN: status = pipe(pipefd); break;
+    case PIPEMEMFD:
+        // Unlike a pipe, a memory file is not bounded by a capacity
+        // while nobody reads it.
+        status = pipefd[PIPEWRTE] = memfd_create("sccroll", 0);
+        if (status >= 0) status = pipefd[PIPEREAD] = dup(pipefd[PIPEWRTE]);
+        break;
     case PIPEDUP:
         pipeside = va_arg(args, int);
         fd = va_arg(args, int);
@@ -848,6 +2295,299 @@ static void sccroll_pipes(SccrollPipes type, const char* restrict name, int pipe
     sccroll_err(status < 0, PIPEDESC[type], name);
 }
 
+// clang-format off
+
+/******************************************************************************
+ * Runner profiling
+ ******************************************************************************/
+// clang-format on
+
+static uint64_t sccroll_clock(void)
+{
+    struct timespec now = { 0 };
+    if (!profile && tracefd < 0) return 0;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * UINT64_C(1000000000) + now.tv_nsec;
+}
+
+static uint64_t sccroll_phase(SccrollPhase phase, uint64_t start)
+{
+    uint64_t end = sccroll_clock();
+    if (profile) {
+        __atomic_fetch_add(&profile->count[phase], 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&profile->nsecs[phase], end - start, __ATOMIC_RELAXED);
+    }
+    if (tracefd >= 0) sccroll_traceSpan(PHASEDESC[phase], "phase", start, end, NULL);
+    return end;
+}
+
+static void sccroll_profile(void)
+{
+    for (int phase = 0; phase < PHASEMAX; ++phase) {
+        if (!profile->count[phase]) continue;
+        fprintf(stderr, PROFILEFMT, PHASEDESC[phase], profile->count[phase],
+            profile->nsecs[phase] / 1e6, profile->nsecs[phase] / 1e3 / profile->count[phase]);
+    }
+}
+
+// clang-format off
+
+/******************************************************************************
+ * Runner tracing
+ ******************************************************************************/
+// clang-format on
+
+static void sccroll_traceOpen(const char* restrict path)
+{
+    tracefd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    sccroll_err(tracefd < 0, "open", path);
+    tracepid = getpid();
+    lane     = 0;
+    sccroll_traceWrite("[\n");
+    sccroll_traceLane("runner");
+}
+
+static void sccroll_traceClose(void)
+{
+    // The last event is not followed by a comma.
+    sccroll_traceWrite(
+        "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%i,\"tid\":0,\"args\":{\"name\":\"sccroll\"}}\n]\n",
+        tracepid
+    );
+    close(tracefd);
+    tracefd = -1;
+}
+
+static void sccroll_traceLane(const char* restrict name)
+{
+    char escaped[TRACENAME] = { 0 };
+    sccroll_traceWrite(
+        "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%i,\"tid\":%i,\"args\":{\"name\":\"%s\"}},\n",
+        tracepid, lane, sccroll_escape(escaped, name)
+    );
+}
+
+static void sccroll_traceSpan(const char* restrict name, const char* restrict category, uint64_t start, uint64_t end, const char* restrict args)
+{
+    char escaped[TRACENAME] = { 0 };
+    sccroll_traceWrite(
+        "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%i,\"tid\":%i,\"args\":%s},\n",
+        sccroll_escape(escaped, name), category, start / 1e3, (end - start) / 1e3, tracepid, lane, args ? args : "{}"
+    );
+}
+
+static void sccroll_traceTest(const SccrollEffects* restrict expected, const SccrollResult* restrict result, bool failed, uint64_t start)
+{
+    char args[TRACEBUFFER] = { 0 };
+    char file[TRACENAME] = { 0 };
+    char failure[TRACENAME + 32] = { 0 };
+    const struct rusage* usage = &result->usage;
+    if (result->failure.type == RECORDASSERT)
+        snprintf(
+            failure, sizeof(failure), ",\"failure\":\"%s:%i\"",
+            sccroll_escape(file, result->failure.where.file), result->failure.where.line
+        );
+    snprintf(
+        args, TRACEBUFFER,
+        "{\"pid\":%i,\"status\":\"%s\",\"code\":%i,\"asserts\":%lu,\"utime\":%.3f,\"stime\":%.3f,\"maxrss\":%li%s}",
+        result->pid, result->limit ? "limit" : failed ? "fail" : "pass", result->code, result->asserts,
+        usage->ru_utime.tv_sec * 1e3 + usage->ru_utime.tv_usec / 1e3,
+        usage->ru_stime.tv_sec * 1e3 + usage->ru_stime.tv_usec / 1e3,
+        usage->ru_maxrss, failure
+    );
+    sccroll_traceSpan(expected->name, "test", start, sccroll_clock(), args);
+}
+
+static void sccroll_traceWrite(const char* restrict format, ...)
+{
+    char event[TRACEBUFFER] = { 0 };
+    va_list args;
+    if (tracefd < 0) return;
+    va_start(args, format);
+    int size = vsnprintf(event, TRACEBUFFER, format, args);
+    va_end(args);
+    if (size >= TRACEBUFFER) size = TRACEBUFFER - 1;
+    sccroll_err(size > 0 && write(tracefd, event, size) < 0, "write", "the trace");
+}
+
+static char* sccroll_escape(char dest[TRACENAME], const char* restrict src)
+{
+    size_t len = 0;
+    for (const unsigned char* c = (const unsigned char*)src; *c && len < TRACENAME - 7; ++c) {
+        if (*c == '"' || *c == '\\') dest[len++] = '\\';
+        if (*c < 0x20) len += sprintf(dest + len, "\\u%04x", *c);
+        else dest[len++] = *c;
+    }
+    dest[len] = 0;
+    return dest;
+}
+
+// clang-format off
+
+/******************************************************************************
+ * Crash forensics
+ ******************************************************************************/
+// clang-format on
+
+static void sccroll_forensics(const SccrollEffects* restrict expected)
+{
+    static char stack[CRASHSTACK];
+    static const int signals[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL };
+    stack_t alternate = { .ss_sp = stack, .ss_size = CRASHSTACK };
+    struct sigaction action = { .sa_sigaction = sccroll_channelCrash, .sa_flags = SA_SIGINFO | SA_ONSTACK | SA_RESETHAND };
+    void* frame = NULL;
+
+    // The first backtrace() call loads its unwinder, which is not
+    // safe in a signal handler.
+    backtrace(&frame, 1);
+    sccroll_err(sigaltstack(&alternate, NULL) < 0, "alternate signal stack", expected->name);
+    for (size_t i = 0; i < sizeof(signals) / sizeof(int); ++i)
+        sccroll_err(sigaction(signals[i], &action, NULL) < 0, "crash handler", expected->name);
+}
+
+// clang-format off
+
+/******************************************************************************
+ * Resources limits
+ ******************************************************************************/
+// clang-format on
+
+static const char* sccroll_cgroup(void)
+{
+    static char path[PATH_MAX] = { 0 };
+    static bool checked        = false;
+    char line[PATH_MAX]        = { 0 };
+    char runner[PATH_MAX]      = { 0 };
+    FILE* stream               = NULL;
+
+    if (checked) return *path ? path : NULL;
+    checked = true;
+
+    // The cgroup v2 line is the one of hierarchy 0.
+    if (!(stream = fopen("/proc/self/cgroup", "r"))) return NULL;
+    while (fgets(line, PATH_MAX, stream) && strncmp(line, "0::", 3));
+    fclose(stream);
+    line[strcspn(line, "\n")] = 0;
+    if (strncmp(line, "0::", 3) || snprintf(path, PATH_MAX, SCCCGROUP "%s", line + 3) >= PATH_MAX)
+        return (*path = 0, NULL);
+    if (!sccroll_cgroupHas(path, "cgroup.controllers", "memory") || access(path, W_OK))
+        return (*path = 0, NULL);
+
+    // A cgroup holding processes cannot delegate its controllers: the
+    // runner moves to its own leaf, next to the ones of the tests.
+    if (snprintf(runner, PATH_MAX, "%s/sccroll.%i", path, getpid()) >= PATH_MAX || (mkdir(runner, 0755) && errno != EEXIST))
+        return (*path = 0, NULL);
+    if (!sccroll_cgroupWrite(runner, "cgroup.procs", "0")) {
+        rmdir(runner);
+        return (*path = 0, NULL);
+    }
+
+    // The other processes of the cgroup, if any, prevent the
+    // delegation; the runner then goes back to its cgroup.
+    sccroll_cgroupWrite(path, "cgroup.subtree_control", "+memory");
+    if (!sccroll_cgroupHas(path, "cgroup.subtree_control", "memory")) {
+        sccroll_cgroupWrite(path, "cgroup.procs", "0");
+        rmdir(runner);
+        *path = 0;
+    }
+    return *path ? path : NULL;
+}
+
+static bool sccroll_cgroupHas(const char* restrict leaf, const char* restrict name, const char* restrict controller)
+{
+    char path[PATH_MAX]      = { 0 };
+    char controllers[SCCMAX] = { 0 };
+    FILE* stream             = NULL;
+
+    if (snprintf(path, PATH_MAX, "%s/%s", leaf, name) >= PATH_MAX || !(stream = fopen(path, "r"))) return false;
+    if (!fgets(controllers, SCCMAX, stream)) *controllers = 0;
+    fclose(stream);
+    return strstr(controllers, controller);
+}
+
+static void sccroll_cgroupOpen(const SccrollEffects* restrict expected, char* restrict leaf)
+{
+    static unsigned count = 0;
+    const char* root      = expected->limits.memory ? sccroll_cgroup() : NULL;
+
+    *leaf = 0;
+    if (!root || snprintf(leaf, PATH_MAX, "%s/sccroll.%i.%u", root, getpid(), count++) >= PATH_MAX)
+        return (void)(*leaf = 0);
+    if (mkdir(leaf, 0755)) return (void)(*leaf = 0);
+    if (!sccroll_cgroupWrite(leaf, "memory.max", "%ju", (uintmax_t)expected->limits.memory)) {
+        rmdir(leaf);
+        *leaf = 0;
+    }
+}
+
+static bool sccroll_cgroupWrite(const char* restrict leaf, const char* restrict name, const char* restrict format, ...)
+{
+    char path[PATH_MAX] = { 0 };
+    va_list args;
+    int fd = snprintf(path, PATH_MAX, "%s/%s", leaf, name) < PATH_MAX ? open(path, O_WRONLY) : -1;
+    bool written = false;
+
+    if (fd < 0) return false;
+    va_start(args, format);
+    written = vdprintf(fd, format, args) > 0;
+    va_end(args);
+    // The cgroup interface files report the errors on close.
+    return !close(fd) && written;
+}
+
+static void sccroll_limit(const SccrollEffects* restrict expected, const char* restrict leaf)
+{
+    const int resources[] = { RLIMIT_AS, RLIMIT_CPU, RLIMIT_NOFILE, RLIMIT_FSIZE };
+    const rlim_t values[] = {
+        expected->limits.memory,
+        expected->limits.cpu,
+        expected->limits.files,
+        expected->limits.output,
+    };
+    struct rlimit limit = { 0 };
+
+    // The rlimits still apply if the cgroup cannot be joined.
+    if (*leaf) sccroll_cgroupWrite(leaf, "cgroup.procs", "0");
+    for (size_t i = 0; i < sizeof(values) / sizeof(rlim_t); ++i) {
+        if (!values[i]) continue;
+        sccroll_err(getrlimit(resources[i], &limit) < 0, "getrlimit", expected->name);
+        // The limits can only be lowered.
+        if (values[i] + (resources[i] == RLIMIT_CPU) < limit.rlim_max)
+            limit.rlim_max = values[i] + (resources[i] == RLIMIT_CPU);
+        limit.rlim_cur = values[i] < limit.rlim_max ? values[i] : limit.rlim_max;
+        sccroll_err(setrlimit(resources[i], &limit) < 0, "setrlimit", expected->name);
+    }
+}
+
+static const char* sccroll_breach(
+    const SccrollEffects* restrict expected, int status, const struct rusage* restrict usage, const char* restrict leaf
+)
+{
+    char path[PATH_MAX]    = { 0 };
+    char line[SCCMAX]      = { 0 };
+    unsigned long long oom = 0;
+    FILE* stream           = NULL;
+    int signal             = WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+    time_t cpu             = usage->ru_utime.tv_sec + usage->ru_stime.tv_sec
+        + (usage->ru_utime.tv_usec + usage->ru_stime.tv_usec) / 1000000;
+
+    if (*leaf) {
+        if (snprintf(path, PATH_MAX, "%s/memory.events", leaf) < PATH_MAX && (stream = fopen(path, "r"))) {
+            while (fgets(line, SCCMAX, stream) && sscanf(line, "oom_kill %llu", &oom) != 1);
+            fclose(stream);
+        }
+        rmdir(leaf);
+    }
+
+    if (!signal || (expected->code.type == SCCSIGNAL && expected->code.value == signal)) return NULL;
+    if (signal == SIGXCPU && expected->limits.cpu) return "CPU time";
+    if (signal == SIGXFSZ && expected->limits.output) return "output size";
+    if (signal == SIGKILL && oom) return "memory";
+    // A test handling or ignoring SIGXCPU is killed at the hard limit.
+    if (signal == SIGKILL && expected->limits.cpu && (rlim_t)cpu >= expected->limits.cpu) return "CPU time";
+    return NULL;
+}
+
 // clang-format off
 
 /******************************************************************************
@@ -855,48 +2595,83 @@ static void sccroll_pipes(SccrollPipes type, const char* restrict name, int pipe
  ******************************************************************************/
 // clang-format on
 
-static void sccroll_codes(SccrollEffects* restrict result, int pipefd[2], int status)
+static void sccroll_codes(const SccrollEffects* restrict expected, SccrollResult* restrict result, int pipefd[2], int status)
 {
-    switch(result->code.type)
+    switch(expected->code.type)
     {
     case SCCERRNUM:
-        sccroll_pipes(PIPEREAD, result->name, pipefd, &result->code.value, sizeof(int));
+        sccroll_pipes(PIPEREAD, expected->name, pipefd, &result->code, sizeof(int));
         break;
     case SCCSTATUS:
-        if (sccroll_hasFlags(result->flags, NOFORK))
-            result->code.value = status;
+        if (sccroll_hasFlags(expected->flags, NOFORK))
+            result->code = status;
         else if (WIFEXITED(status))
-            result->code.value = WEXITSTATUS(status);
+            result->code = WEXITSTATUS(status);
         break;
     default: // SCCSIGNAL
-        if (sccroll_hasFlags(result->flags, NOFORK))
-            result->code.value = status;
+        if (sccroll_hasFlags(expected->flags, NOFORK))
+            result->code = status;
         else if (WIFSIGNALED(status))
-            result->code.value = WTERMSIG(status);
+            result->code = WTERMSIG(status);
         break;
     }
 }
 
-static void sccroll_std(SccrollEffects* restrict result, int pipefd[SCCMAXSTD][2])
+static void sccroll_std(const SccrollEffects* restrict expected, SccrollResult* restrict result, int pipefd[SCCMAXSTD][2])
 {
-    // expected and result share the same pointer, freeing both would
-    // raise an error. This one is thus reset to avoid the situation.
-    result->std[STDIN_FILENO].content.blob = NULL;
-
     char buffer[SCCMAX] = { 0 };
-    for (int i = STDOUT_FILENO; i < SCCMAXSTD; ++i, memset(buffer, 0, strlen(buffer))) {
-        sccroll_pipes(PIPEREAD, result->name, pipefd[i], buffer, SCCMAX);
-        result->std[i].content.blob =
-            sccroll_hasFlags(result->flags, NOSTRP)
-            ? strdup(buffer)
-            : sccroll_strip(buffer);
+    char* content = NULL;
+    for (int i = STDOUT_FILENO; i < SCCMAXSTD; ++i, memset(buffer, 0, sizeof(buffer))) {
+        // The last byte is kept for the null terminator.
+        sccroll_pipes(PIPEREAD, expected->name, pipefd[i], buffer, SCCMAX - 1);
+        result->std[i].size = strlen(buffer);
+        content = sccroll_hasFlags(expected->flags, NOSTRP) ? buffer : sccroll_trim(buffer);
+        result->std[i].blob = sccroll_adup(content, strlen(content), expected->name);
+    }
+}
+
+static void sccroll_assertsSend(const SccrollEffects* restrict expected, int pipefd[2])
+{
+    sccroll_err(sccroll_channelFlush(pipefd[PIPEWRTE]) < 0, PIPEDESC[PIPEWRTE], expected->name);
+    sccroll_pipes(PIPECLOSE, expected->name, pipefd, PIPEWRTE);
+}
+
+static void sccroll_assertsRecv(const SccrollEffects* restrict expected, SccrollResult* restrict result, int pipefd[2])
+{
+    SccrollRecord record = { 0 };
+    struct stat file = { 0 };
+    char* buffer = NULL;
+    size_t size = 0, next = 0;
+
+    sccroll_err(fstat(pipefd[PIPEREAD], &file) < 0, PIPEDESC[PIPEREAD], expected->name);
+    if (!file.st_size) return;
+    // The records strings point into the arena.
+    buffer = sccroll_adup(NULL, file.st_size, expected->name);
+    sccroll_err(pread(pipefd[PIPEREAD], buffer, file.st_size, 0) != file.st_size, PIPEDESC[PIPEREAD], expected->name);
+    while ((next = sccroll_recordRead(buffer + size, file.st_size - size, &record))) size += next;
+    if (!size) return;
+
+    result->records.blob = buffer;
+    result->records.size = size;
+    for (size_t offset = 0; (next = sccroll_recordRead((char*)result->records.blob + offset, size - offset, &record)); offset += next) {
+        switch (record.type) {
+        case RECORDCOUNT: result->asserts = record.value; break;
+        case RECORDFAILED: result->expects = record.value; break;
+        case RECORDASSERT:
+        case RECORDSIGNAL: result->failure = record; break;
+        default: break;
+        }
     }
 }
 
-static void sccroll_files(SccrollEffects* restrict result)
+static void sccroll_files(const SccrollEffects* restrict expected, SccrollResult* restrict result)
 {
-    for (int i = 0; i < SCCMAX && result->files[i].path; ++i)
-        sccroll_fread(&result->files[i], result->name);
+    for (size_t i = 0; i < result->len; ++i)
+        if (expected->files[i].hash)
+            sccroll_fhash(expected->files[i].path, &result->files[i], expected->name);
+        // Trees are compared in place.
+        else if (!expected->files[i].tree)
+            sccroll_fread(expected->files[i].path, &result->files[i], expected->name);
 }
 
 // clang-format off
@@ -906,35 +2681,78 @@ static void sccroll_files(SccrollEffects* restrict result)
  ******************************************************************************/
 // clang-format on
 
-static bool sccroll_diff(const SccrollEffects* restrict expected, const SccrollEffects* restrict result)
+static bool sccroll_diff(const SccrollEffects* restrict expected, const SccrollResult* restrict result)
 {
+    // The other effects are truncated, and not compared.
+    if (result->limit) {
+        fprintf(stderr, LIMITFMT, expected->name, result->limit);
+        return true;
+    }
+
     // We want to compare all data before returning the result of
     // comparison, hence the not-directly-or'ed.
     bool diff = sccroll_diffCodes(expected, result);
     diff |= sccroll_diffStd(expected, result);
     diff |= sccroll_diffFiles(expected, result);
+    diff |= sccroll_diffAsserts(expected, result);
     return diff;
 }
 
-static bool sccroll_diffCodes(const SccrollEffects* restrict expected, const SccrollEffects* restrict result)
+static bool sccroll_diffCodes(const SccrollEffects* restrict expected, const SccrollResult* restrict result)
 {
-    if (expected->code.value != result->code.value) {
-        if(!sccroll_hasFlags(expected->flags, NODIFF))
+    if (expected->code.value != result->code) {
+        if(!sccroll_hasFlags(expected->flags, NODIFF)) {
             sccroll_pcodes(expected, result);
+            if (result->failure.type == RECORDASSERT) {
+                fprintf(stderr, ASSERTFMT, expected->name);
+                sccroll_precord(&result->failure);
+            }
+            else if (result->failure.type == RECORDSIGNAL)
+                fprintf(stderr, SIGNALFMT, expected->name, result->failure.text);
+        }
         return true;
     }
     return false;
 }
 
-static bool sccroll_diffStd(const SccrollEffects* restrict expected, const SccrollEffects* restrict result)
+static bool sccroll_diffAsserts(const SccrollEffects* restrict expected, const SccrollResult* restrict result)
+{
+    bool none = sccroll_hasFlags(expected->flags, ASSERTS) && !result->asserts;
+    SccrollRecord record = { 0 };
+    const char* records = result->records.blob ? result->records.blob : "";
+    size_t size = result->records.size, next = 0;
+    int listed = 0;
+
+    if (!sccroll_hasFlags(expected->flags, NODIFF)) {
+        if (result->expects) fprintf(stderr, EXPECTFMT, expected->name, result->expects);
+        for (size_t offset = 0; (next = sccroll_recordRead(records + offset, size - offset, &record)); offset += next)
+            if (record.type == RECORDEXPECT) sccroll_precord(&record), ++listed;
+        if (listed < result->expects) fprintf(stderr, UNLISTEDFMT, result->expects - listed);
+        if (none) fprintf(stderr, DIFFFMT, expected->name, "no assertion checked");
+        for (size_t offset = 0; (next = sccroll_recordRead(records + offset, size - offset, &record)); offset += next)
+            if (record.type == RECORDMETRIC) fprintf(stderr, METRICFMT, expected->name, record.where.expr, record.value);
+    }
+    return result->expects || none;
+}
+
+static void sccroll_precord(const SccrollRecord* restrict record)
+{
+    if (record->where.file && *record->where.file)
+        fprintf(stderr, SCCLOCATIONFMT, record->where.file, record->where.line, record->where.expr);
+    fprintf(stderr, "%s\n", record->text);
+}
+
+static bool sccroll_diffStd(const SccrollEffects* restrict expected, const SccrollResult* restrict result)
 {
     bool diff = false;
+    size_t explen = 0;
     SccrollBlobDiff infos = { .name = expected->name };
     for (int i = STDOUT_FILENO; i < SCCMAXSTD; ++i)
-        if (strcmp(expected->std[i].content.blob, result->std[i].content.blob)) {
+        if ((explen = strlen(expected->std[i].content.blob)) != strlen(result->std[i].blob)
+            || blobspan(expected->std[i].content.blob, result->std[i].blob, explen, true) != explen) {
             if (!sccroll_hasFlags(expected->flags, NODIFF)) {
                 infos.expected = &expected->std[i].content;
-                infos.result = &result->std[i].content;
+                infos.result = &result->std[i];
                 infos.desc = i == STDOUT_FILENO ? "stdout" : "stderr";
                 sccroll_pdiff(&infos);
             }
@@ -943,28 +2761,36 @@ static bool sccroll_diffStd(const SccrollEffects* restrict expected, const Sccro
     return diff;
 }
 
-static bool sccroll_diffFiles(const SccrollEffects* restrict expected, const SccrollEffects* restrict result)
+static bool sccroll_diffFiles(const SccrollEffects* restrict expected, const SccrollResult* restrict result)
 {
     bool diff = false;
     size_t explen = 0, reslen = 0;
     SccrollBlobDiff infos = { .name = expected->name };
 
     for (int i = 0; i < SCCMAX && (bool)expected->files[i].path; ++i, explen = 0, reslen = 0) {
+        if (expected->files[i].tree) {
+            diff |= sccroll_diffTree(expected, i);
+            continue;
+        }
+        if (expected->files[i].hash) {
+            diff |= sccroll_diffHash(expected, result, i);
+            continue;
+        }
         if (expected->files[i].content.size) {
             explen = expected->files[i].content.size;
-            reslen = result->files[i].content.size;
+            reslen = result->files[i].size;
         }
         else {
             explen = strlen(expected->files[i].content.blob);
-            reslen = strlen(result->files[i].content.blob);
+            reslen = strlen(result->files[i].blob);
         }
 
         if (explen != reslen
-            || memcmp(expected->files[i].content.blob, result->files[i].content.blob, explen)) {
+            || blobspan(expected->files[i].content.blob, result->files[i].blob, explen, true) != explen) {
             diff = true;
             if (!sccroll_hasFlags(expected->flags, NODIFF)) {
                 infos.expected = &expected->files[i].content;
-                infos.result = &result->files[i].content;
+                infos.result = &result->files[i];
                 infos.desc = expected->files[i].path;
                 expected->files[i].content.size
                     ? sccroll_dump(&infos)
@@ -975,9 +2801,64 @@ static bool sccroll_diffFiles(const SccrollEffects* restrict expected, const Scc
     return diff;
 }
 
-static void sccroll_pcodes(const SccrollEffects* restrict expected, const SccrollEffects* restrict result)
+static bool sccroll_diffHash(const SccrollEffects* restrict expected, const SccrollResult* restrict result, int index)
+{
+    const SccrollFile* exp          = &expected->files[index];
+    const Data* res                 = &result->files[index];
+    const char* paths[2]            = { exp->ref, exp->path };
+    char bytes[2][DUMPWINDOW + 1]   = { 0 };
+    char desc[PATH_MAX + MAXLINE]   = { 0 };
+    Data window[2]                  = { { .blob = bytes[0] }, { .blob = bytes[1] } };
+    SccrollBlobDiff infos           = { .expected = &window[0], .result = &window[1], .name = expected->name, .desc = desc };
+    FILE* streams[2]                = { NULL };
+    struct stat reference           = { .st_size = exp->content.size };
+    off_t offset                    = 0;
+
+    if ((!exp->content.size || exp->content.size == res->size)
+        && !strcasecmp(exp->hash, res->blob))
+        return false;
+    if (sccroll_hasFlags(expected->flags, NODIFF)) return true;
+
+    if (!exp->ref) fprintf(stderr, DIFFFMT, expected->name, exp->path);
+    else {
+        // Only the mismatching files are read again, by chunks, up to
+        // the first difference.
+        for (int i = 0; i < 2; ++i) sccroll_err(!(streams[i] = fopen(paths[i], "rb")), paths[i], expected->name);
+        if (!exp->content.size) sccroll_err(fstat(fileno(streams[0]), &reference), paths[0], expected->name);
+        offset = sccroll_foffset(streams);
+        for (int i = 0; i < 2; ++i) {
+            sccroll_err(fseeko(streams[i], offset > DUMPBEFORE ? offset - DUMPBEFORE : 0, SEEK_SET), paths[i], expected->name);
+            window[i].size = fread(bytes[i], sizeof(char), DUMPWINDOW, streams[i]);
+            sccroll_err(ferror(streams[i]), paths[i], expected->name);
+            fclose(streams[i]);
+        }
+        snprintf(desc, sizeof(desc), "%s [byte %jd]", exp->path, (intmax_t)offset);
+        sccroll_dump(&infos);
+    }
+    fprintf(stderr, HASHFMT, "exp", NORMAL, GREEN, exp->hash, (size_t)reference.st_size);
+    fprintf(stderr, HASHFMT, "res", NORMAL, RED, (char*)res->blob, res->size);
+    return true;
+}
+
+static off_t sccroll_foffset(FILE* streams[2])
 {
-    int exp = expected->code.value, res = result->code.value;
+    char expected[SCCMAX] = { 0 };
+    char result[SCCMAX] = { 0 };
+    size_t expc = 0, resc = 0, span = 0;
+    off_t offset = 0;
+
+    do {
+        expc = fread(expected, sizeof(char), SCCMAX, streams[0]);
+        resc = fread(result, sizeof(char), SCCMAX, streams[1]);
+        span = blobspan(expected, result, expc < resc ? expc : resc, true);
+        offset += span;
+    } while (span == SCCMAX && expc == resc);
+    return offset;
+}
+
+static void sccroll_pcodes(const SccrollEffects* restrict expected, const SccrollResult* restrict result)
+{
+    int exp = expected->code.value, res = result->code;
     char expdesc[MAXLINE] = { 0 };
     char resdesc[MAXLINE] = { 0 };
     char* desc = NULL;
@@ -1043,25 +2924,30 @@ static void sccroll_dump(const SccrollBlobDiff* restrict infos)
     char* expdata            = infos->expected->blob;
     char* resdata            = infos->result->blob;
     bool same                = false;
+    size_t common            = 1 + (infos->expected->size < infos->result->size
+                                    ? infos->expected->size
+                                    : infos->result->size);
+    size_t next              = 0;
 
     fprintf(stderr, DIFFFMT, infos->name, infos->desc);
     for (size_t i = 0; i <= infos->expected->size || i <= infos->result->size; ++i) {
-        same =
-            i <= infos->expected->size
-            && i <= infos->result->size
-            && expdata[i] == resdata[i];
+        // The bytes are compared by runs of equal or different ones,
+        // up to the end of the shortest blob (trailing null included).
+        if (i == next && i < common)
+            next = i + blobspan(expdata + i, resdata + i, common - i, (same = expdata[i] == resdata[i]));
+        else if (i >= common) same = false;
 
         if (same && i <= infos->expected->size)
-            sprintf(expbuffer, HEXFMT, digits, expdata[i]);
+            sprintf(expbuffer, HEXFMT, digits, (unsigned char)expdata[i]);
         else if (i <= infos->expected->size)
-            sprintf(expbuffer, COLHEXFMT, NORMAL, GREEN, digits, expdata[i]);
+            sprintf(expbuffer, COLHEXFMT, NORMAL, GREEN, digits, (unsigned char)expdata[i]);
         else if (*expbuffer)
             memset(expbuffer, 0, sizeof(char)*strlen(expbuffer));
 
         if (same && i <= infos->result->size)
-            sprintf(resbuffer, HEXFMT, digits, resdata[i]);
+            sprintf(resbuffer, HEXFMT, digits, (unsigned char)resdata[i]);
         else if (i <= infos->result->size)
-            sprintf(resbuffer, COLHEXFMT, NORMAL, RED, digits, resdata[i]);
+            sprintf(resbuffer, COLHEXFMT, NORMAL, RED, digits, (unsigned char)resdata[i]);
         else if (*resbuffer)
             memset(resbuffer, 0, sizeof(char)*strlen(resbuffer));
 
@@ -1074,13 +2960,307 @@ static void sccroll_dump(const SccrollBlobDiff* restrict infos)
 static void sccroll_review(int report[REPORTMAX])
 {
     int passed    = report[REPORTTOTAL] - report[REPORTFAIL];
-    float percent = 100.0 * passed / report[REPORTTOTAL];
+    float percent = report[REPORTTOTAL] ? 100.0 * passed / report[REPORTTOTAL] : 100.0;
     fprintf(stderr, REPORTFMT,
         report[REPORTFAIL] ? RED : GREEN,
         report[REPORTFAIL] ? "FAIL" : "PASS",
         "success rate", percent, passed, report[REPORTTOTAL]);
 }
 
+// clang-format off
+
+/******************************************************************************
+ * Files trees comparison
+ ******************************************************************************/
+// clang-format on
+
+static bool sccroll_diffTree(const SccrollEffects* restrict expected, int index)
+{
+    bool diff = false;
+    char path[PATH_MAX] = { 0 };
+    pthread_t threads[TREEWORKERS] = { 0 };
+    long workers = sysconf(_SC_NPROCESSORS_ONLN);
+    SccrollTree tree = {
+        .expected = expected->files[index].tree,
+        .result   = expected->files[index].path,
+        .name     = expected->name,
+    };
+
+    sccroll_treeList(&tree);
+    workers = workers < 1 ? 1 : workers > TREEWORKERS ? TREEWORKERS : workers;
+    workers = (size_t)workers > tree.len ? (long)tree.len : workers;
+    // The current thread is one of the workers.
+    for (long i = 1; i < workers; ++i)
+        sccroll_err(pthread_create(&threads[i], NULL, sccroll_treeWorker, &tree), tree.result, tree.name);
+    sccroll_treeWorker(&tree);
+    for (long i = 1; i < workers; ++i) pthread_join(threads[i], NULL);
+
+    for (size_t i = 0; i < tree.len; ++i) {
+        if (tree.files[i].status == TREESAME) continue;
+        // The reference tree is now the same as the obtained one.
+        if (update) {
+            snprintf(path, sizeof(path), "%s/%s", tree.expected, tree.files[i].path);
+            fprintf(stderr, UPDATEFMT, tree.name, path);
+            continue;
+        }
+        if (!diff) {
+            diff = true;
+            if (sccroll_hasFlags(expected->flags, NODIFF)) break;
+            fprintf(stderr, DIFFFMT, tree.name, tree.result);
+        }
+        switch (tree.files[i].status)
+        {
+        case TREEMISSING:
+            fprintf(stderr, TREEFMT "\n", "missing", NORMAL, GREEN, tree.files[i].path);
+            break;
+        case TREEEXTRA:
+            fprintf(stderr, TREEFMT "\n", "extra", NORMAL, RED, tree.files[i].path);
+            break;
+        case TREEDIFF:
+            fprintf(stderr, TREEFMT, "differs", NORMAL, CYAN, tree.files[i].path);
+            tree.files[i].expsize != tree.files[i].ressize
+                ? fprintf(stderr, SIZESFMT, (intmax_t)tree.files[i].expsize, (intmax_t)tree.files[i].ressize)
+                : fprintf(stderr, OFFSETFMT, (intmax_t)tree.files[i].offset);
+            break;
+        default: // TREESAME
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < tree.len; ++i) free(tree.files[i].path);
+    free(tree.files);
+    return diff;
+}
+
+static void sccroll_treeList(SccrollTree* restrict tree)
+{
+    char *expz = NULL, *resz = NULL;
+    size_t expc = 0, resc = 0, explen = 0, reslen = 0, i = 0, j = 0;
+    char **exp = NULL, **res = NULL;
+    int cmp = 0;
+
+    sccroll_treeWalk(tree->expected, NULL, &expz, &expc);
+    sccroll_treeWalk(tree->result, NULL, &resz, &resc);
+    exp = sccroll_treeSort(expz, expc, (explen = argz_count(expz, expc)));
+    res = sccroll_treeSort(resz, resc, (reslen = argz_count(resz, resc)));
+    tree->files = calloc(explen + reslen + 1, sizeof(SccrollTreeFile));
+    sccroll_err(!tree->files, "alloc", tree->name);
+
+    // Both lists are sorted, the union is obtained by a merge.
+    for (tree->len = 0; i < explen || j < reslen; ++tree->len) {
+        cmp = i == explen ? 1 : j == reslen ? -1 : strcmp(exp[i], res[j]);
+        tree->files[tree->len].status = cmp < 0 ? TREEMISSING : cmp > 0 ? TREEEXTRA : TREESAME;
+        tree->files[tree->len].path = strdup(cmp > 0 ? res[j] : exp[i]);
+        sccroll_err(!tree->files[tree->len].path, "alloc", tree->name);
+        i += cmp <= 0;
+        j += cmp >= 0;
+    }
+
+    free(exp);
+    free(res);
+    free(expz);
+    free(resz);
+}
+
+static void sccroll_treeWalk(const char* restrict root, const char* restrict dir, char** argz, size_t* len)
+{
+    char path[PATH_MAX] = { 0 };
+    char relative[PATH_MAX] = { 0 };
+    struct dirent* entry = NULL;
+    struct stat infos;
+
+    snprintf(path, sizeof(path), "%s/%s", root, dir ? dir : "");
+    // A missing tree is empty.
+    DIR* stream = opendir(path);
+    if (!stream) return;
+
+    while ((entry = readdir(stream))) {
+        if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..")) continue;
+        dir
+            ? snprintf(relative, sizeof(relative), "%s/%s", dir, entry->d_name)
+            : snprintf(relative, sizeof(relative), "%s", entry->d_name);
+        if (snprintf(path, sizeof(path), "%s/%s", root, relative) >= PATH_MAX
+            || lstat(path, &infos))
+            continue;
+        if (S_ISDIR(infos.st_mode)) sccroll_treeWalk(root, relative, argz, len);
+        else if (S_ISREG(infos.st_mode))
+            sccroll_err(argz_add(argz, len, relative), "alloc", root);
+    }
+    closedir(stream);
+}
+
+static char** sccroll_treeSort(char* argz, size_t len, size_t count)
+{
+    char** paths = calloc(count + 1, sizeof(char*));
+    sccroll_err(!paths, "alloc", "tree");
+    argz_extract(argz, len, paths);
+    qsort(paths, count, sizeof(char*), sccroll_treeCmp);
+    return paths;
+}
+
+static int sccroll_treeCmp(const void* a, const void* b)
+{
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+static void* sccroll_treeWorker(void* tree)
+{
+    SccrollTree* shared = tree;
+    size_t i = 0;
+    while ((i = __atomic_fetch_add(&shared->next, 1, __ATOMIC_RELAXED)) < shared->len) {
+        if (shared->files[i].status == TREESAME)
+            sccroll_treeCompare(shared, &shared->files[i]);
+        if (update && shared->files[i].status != TREESAME)
+            sccroll_treeUpdate(shared, &shared->files[i]);
+    }
+    return NULL;
+}
+
+static void sccroll_treeCompare(const SccrollTree* restrict tree, SccrollTreeFile* restrict file)
+{
+    char paths[2][PATH_MAX] = { 0 };
+    char hex[2][SCCHASHHEX] = { 0 };
+    struct stat infos[2];
+    FILE* streams[2] = { NULL };
+
+    snprintf(paths[0], PATH_MAX, "%s/%s", tree->expected, file->path);
+    snprintf(paths[1], PATH_MAX, "%s/%s", tree->result, file->path);
+    for (int i = 0; i < 2; ++i) sccroll_err(stat(paths[i], &infos[i]), paths[i], tree->name);
+    file->expsize = infos[0].st_size;
+    file->ressize = infos[1].st_size;
+    // Different sizes do not need any read.
+    if (file->expsize != file->ressize) {
+        file->status = TREEDIFF;
+        return;
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        sccroll_err(!(streams[i] = fopen(paths[i], "rb")), paths[i], tree->name);
+        sccroll_err(sccroll_hashFile(streams[i], hex[i]) < 0, paths[i], tree->name);
+    }
+    // Only the mismatching files are read again.
+    if (strcmp(hex[0], hex[1])) {
+        file->status = TREEDIFF;
+        rewind(streams[0]);
+        rewind(streams[1]);
+        file->offset = sccroll_foffset(streams);
+    }
+    fclose(streams[0]);
+    fclose(streams[1]);
+}
+
+// clang-format off
+
+/******************************************************************************
+ * Expectations update
+ ******************************************************************************/
+// clang-format on
+
+static void sccroll_update(SccrollEffects* restrict expected, const SccrollResult* restrict result)
+{
+    char* content = NULL;
+    size_t length = 0;
+    SccrollFile* file = NULL;
+    FILE* source = NULL;
+    bool stripped = !sccroll_hasFlags(expected->flags, NOSTRP);
+
+    for (int i = STDOUT_FILENO; i < SCCMAXSTD; ++i) {
+        content = result->std[i].blob;
+        length  = strlen(content);
+        if (!expected->std[i].path
+            || (strlen(expected->std[i].content.blob) == length
+                && blobspan(expected->std[i].content.blob, content, length, true) == length))
+            continue;
+        // A full capture may miss the end of the output.
+        if (result->std[i].size >= SCCMAX - 1) {
+            fprintf(stderr, NOUPDATEFMT, expected->name, expected->std[i].path, "output truncated");
+            continue;
+        }
+
+        // Stripped contents ignore the final newline anyway.
+        if (stripped && length) {
+            sccroll_err(asprintf(&content, "%s\n", content) < 0, "alloc", expected->name);
+            sccroll_fsave(expected->std[i].path, NULL, content, length + 1, expected->name);
+            free(content);
+        }
+        else sccroll_fsave(expected->std[i].path, NULL, content, length, expected->name);
+
+        expected->std[i].content.blob = sccroll_adup(result->std[i].blob, strlen(result->std[i].blob), expected->name);
+        fprintf(stderr, UPDATEFMT, expected->name, expected->std[i].path);
+    }
+
+    for (int i = 0; i < SCCMAX && (file = &expected->files[i])->path; ++i) {
+        content = result->files[i].blob;
+        if (!file->hash || !file->ref
+            || ((!file->content.size || file->content.size == result->files[i].size)
+                && !strcasecmp(file->hash, content)))
+            continue;
+
+        sccroll_err(!(source = fopen(file->path, "rb")), file->path, expected->name);
+        sccroll_fsave(file->ref, source, NULL, 0, expected->name);
+        fclose(source);
+
+        file->hash = sccroll_adup(content, strlen(content) + 1, expected->name);
+        if (file->content.size) file->content.size = result->files[i].size;
+        fprintf(stderr, UPDATEFMT, expected->name, file->ref);
+        fprintf(stderr, HASHFMT, "new", NORMAL, CYAN, content, result->files[i].size);
+    }
+}
+
+static void sccroll_treeUpdate(const SccrollTree* restrict tree, const SccrollTreeFile* restrict file)
+{
+    char paths[2][PATH_MAX] = { 0 };
+    FILE* source = NULL;
+
+    snprintf(paths[0], PATH_MAX, "%s/%s", tree->expected, file->path);
+    if (file->status == TREEMISSING) {
+        sccroll_err(remove(paths[0]), paths[0], tree->name);
+        return;
+    }
+
+    snprintf(paths[1], PATH_MAX, "%s/%s", tree->result, file->path);
+    sccroll_err(!(source = fopen(paths[1], "rb")), paths[1], tree->name);
+    sccroll_fsave(paths[0], source, NULL, 0, tree->name);
+    fclose(source);
+}
+
+static void sccroll_fsave(const char* restrict path, FILE* restrict source, const void* restrict blob, size_t size, const char* restrict name)
+{
+    char buffer[SCCMAX] = { 0 };
+    char* temp = NULL;
+    FILE* stream = NULL;
+    struct stat infos;
+    int fd = -1;
+
+    sccroll_mkdirs(path, name);
+    sccroll_err(asprintf(&temp, "%s.XXXXXX", path) < 0, "alloc", name);
+    sccroll_err((fd = mkstemp(temp)) < 0, temp, name);
+    // Keep the replaced file permissions.
+    sccroll_err(fchmod(fd, stat(path, &infos) ? 0644 : infos.st_mode & 07777), temp, name);
+    sccroll_err(!(stream = fdopen(fd, "wb")), temp, name);
+
+    if (!source) sccroll_err(size && fwrite(blob, 1, size, stream) != size, temp, name);
+    else
+        while ((size = fread(buffer, sizeof(char), SCCMAX, source)))
+            sccroll_err(fwrite(buffer, sizeof(char), size, stream) != size, temp, name);
+    sccroll_err(source && ferror(source), path, name);
+
+    sccroll_err(fclose(stream) || rename(temp, path), path, name);
+    free(temp);
+}
+
+static void sccroll_mkdirs(const char* restrict path, const char* restrict name)
+{
+    char parents[PATH_MAX] = { 0 };
+    strncpy(parents, path, PATH_MAX - 1);
+    for (char* slash = strchr(parents + 1, '/'); slash; slash = strchr(slash + 1, '/')) {
+        *slash = 0;
+        // Concurrent workers may create the same directory.
+        sccroll_err(mkdir(parents, 0755) && errno != EEXIST, parents, name);
+        *slash = '/';
+    }
+}
+
 // clang-format off
 
 /******************************************************************************
@@ -1091,7 +3271,7 @@ static void sccroll_review(int report[REPORTMAX])
 static void sccroll_free(const SccrollEffects* restrict effects)
 {
     for (int i = 0; i < SCCMAX && (effects->files[i].path || i < SCCMAXSTD); ++i) {
-        if (i < SCCMAXSTD) free(effects->std[i].content.blob);
+        if (i < SCCMAXSTD && !effects->std[i].path) free(effects->std[i].content.blob);
         free(effects->files[i].content.blob);
     }
 
@@ -1102,6 +3282,11 @@ static void sccroll_atexit(void)
 {
     // Freeing the reports separator line.
     free((void*)SCCSEP);
+    sccroll_arenaFree(&arena);
+    while (fixtures && fixtures->len) free(lpop(fixtures));
+    lfree(fixtures);
+    while (suites && suites->len) free(lpop(suites));
+    lfree(suites);
 }
 
 /** @} @} **/
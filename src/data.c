@@ -14,6 +14,16 @@
 
 #include "sccroll/data.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * @def SCCSIMD
+ * @since 0.1.0
+ * @brief Defined if the vectorized comparison kernels are available.
+ */
+#define SCCSIMD
+#include <immintrin.h>
+#endif
+
 /**
  * @since 0.1.0
  * @brief Initialise a new pseudo-random seed.
@@ -41,6 +51,110 @@ static void sccroll_peanuts(void) __attribute__((constructor));
  */
 void arc4random_buf(void* blob, size_t size) __attribute__((weak, nonnull(1)));
 
+/**
+ * @typedef SccrollSpan
+ * @since 0.1.0
+ * @brief Comparison kernels type.
+ * @see blobspan()
+ */
+typedef size_t (*SccrollSpan)(const uint8_t* restrict, const uint8_t* restrict, size_t, bool);
+
+/**
+ * @since 0.1.0
+ * @brief Select the best comparison kernel for the CPU.
+ *
+ * The kernel is selected once at load time, as blobspan() is called
+ * concurrently by the trees comparison workers.
+ */
+static void sccroll_spanSelect(void) __attribute__((constructor));
+
+/**
+ * @since 0.1.0
+ * @brief Bytes loop comparison kernel.
+ * @see blobspan()
+ */
+static size_t sccroll_spanScalar(const uint8_t* restrict a, const uint8_t* restrict b, size_t size, bool equal);
+
+#ifdef SCCSIMD
+/**
+ * @since 0.1.0
+ * @brief SSE2 comparison kernel.
+ * @see blobspan()
+ */
+static size_t sccroll_spanSSE2(const uint8_t* restrict a, const uint8_t* restrict b, size_t size, bool equal)
+    __attribute__((target("sse2")));
+
+/**
+ * @since 0.1.0
+ * @brief AVX2 comparison kernel.
+ * @see blobspan()
+ */
+static size_t sccroll_spanAVX2(const uint8_t* restrict a, const uint8_t* restrict b, size_t size, bool equal)
+    __attribute__((target("avx2")));
+
+/**
+ * @since 0.1.0
+ * @brief AVX-512 comparison kernel.
+ * @see blobspan()
+ */
+static size_t sccroll_spanAVX512(const uint8_t* restrict a, const uint8_t* restrict b, size_t size, bool equal)
+    __attribute__((target("avx512f,avx512bw")));
+#endif // SCCSIMD
+
+/**
+ * @var span
+ * @since 0.1.0
+ * @brief The comparison kernel used by blobspan().
+ */
+static SccrollSpan span = sccroll_spanScalar;
+
+/**
+ * @enum SccrollHashFlags
+ * @since 0.1.0
+ * @brief BLAKE3 domain separation flags.
+ */
+typedef enum SccrollHashFlags {
+    CHUNKSTART = 1, /**< First block of a chunk. */
+    CHUNKEND   = 2, /**< Last block of a chunk. */
+    PARENT     = 4, /**< Parent node of the chunks tree. */
+    ROOT       = 8, /**< Root node of the chunks tree. */
+} SccrollHashFlags;
+
+/**
+ * @var IV
+ * @since 0.1.0
+ * @brief BLAKE3 initialization vector.
+ */
+static const uint32_t IV[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+    0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19,
+};
+
+/**
+ * @since 0.1.0
+ * @brief BLAKE3 compression function.
+ * @param cv The input chaining value.
+ * @param block The block to compress.
+ * @param counter The chunk counter.
+ * @param blocklen The @p block length.
+ * @param flags The SccrollHashFlags of the block.
+ * @param out The compression output.
+ */
+static void sccroll_hashCompress(
+    const uint32_t cv[8], const uint8_t block[SCCHASHBLOCK], uint64_t counter,
+    uint32_t blocklen, uint32_t flags, uint32_t out[16]
+) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Build a parent node block from its children chaining
+ * values.
+ * @param left,right The children chaining values.
+ * @param block The parent block.
+ */
+static void sccroll_hashBlock(const uint32_t left[8], const uint32_t right[8], uint8_t block[SCCHASHBLOCK])
+    __attribute__((nonnull));
+
 // clang-format off
 
 /******************************************************************************
@@ -94,3 +208,295 @@ void* blobdup(const void* restrict blob, size_t size)
     if (blob) memcpy(copy, blob, size);
     return copy;
 }
+
+// clang-format off
+
+/******************************************************************************
+ * Arena allocation
+ ******************************************************************************/
+// clang-format on
+
+void* sccroll_arenaAlloc(SccrollArena* restrict arena, size_t size)
+{
+    SccrollChunk* chunk = arena->head;
+    void* memory = NULL;
+
+    size = (size + SCCARENAALIGN - 1) & ~(size_t)(SCCARENAALIGN - 1);
+    if (!chunk || chunk->size - chunk->used < size) {
+        chunk = malloc(sizeof(SccrollChunk) + (size > SCCARENACHUNK ? size : SCCARENACHUNK));
+        if (!chunk) return NULL;
+        chunk->size = size > SCCARENACHUNK ? size : SCCARENACHUNK;
+        chunk->used = 0;
+        chunk->next = arena->head;
+        arena->head = chunk;
+    }
+
+    memory = chunk->data + chunk->used;
+    chunk->used += size;
+    return memory;
+}
+
+void* sccroll_arenaDup(SccrollArena* restrict arena, const void* restrict blob, size_t size)
+{
+    char* copy = sccroll_arenaAlloc(arena, size + 1);
+    if (!copy) return NULL;
+    blob ? memcpy(copy, blob, size) : memset(copy, 0, size);
+    copy[size] = 0;
+    return copy;
+}
+
+void sccroll_arenaReset(SccrollArena* restrict arena)
+{
+    SccrollChunk* next = NULL;
+    if (!arena->head) return;
+    while (arena->head->next) {
+        next = arena->head->next;
+        free(arena->head);
+        arena->head = next;
+    }
+    arena->head->used = 0;
+}
+
+void sccroll_arenaFree(SccrollArena* restrict arena)
+{
+    sccroll_arenaReset(arena);
+    free(arena->head);
+    arena->head = NULL;
+}
+
+// clang-format off
+
+/******************************************************************************
+ * Data comparison
+ ******************************************************************************/
+// clang-format on
+
+size_t blobspan(const void* restrict a, const void* restrict b, size_t size, bool equal)
+{
+    return span(a, b, size, equal);
+}
+
+static void sccroll_spanSelect(void)
+{
+#ifdef SCCSIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw")) span = sccroll_spanAVX512;
+    else if (__builtin_cpu_supports("avx2")) span = sccroll_spanAVX2;
+    else if (__builtin_cpu_supports("sse2")) span = sccroll_spanSSE2;
+#endif
+}
+
+static size_t sccroll_spanScalar(const uint8_t* restrict a, const uint8_t* restrict b, size_t size, bool equal)
+{
+    size_t i = 0;
+    while (i < size && (a[i] == b[i]) == equal) ++i;
+    return i;
+}
+
+#ifdef SCCSIMD
+static size_t sccroll_spanSSE2(const uint8_t* restrict a, const uint8_t* restrict b, size_t size, bool equal)
+{
+    size_t i = 0;
+    uint32_t mask = 0;
+    for (; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi8(
+            _mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i))
+        ));
+        // Search the first byte breaking the span.
+        if ((mask = equal ? ~mask & 0xFFFF : mask)) return i + __builtin_ctz(mask);
+    }
+    return i + sccroll_spanScalar(a + i, b + i, size - i, equal);
+}
+
+static size_t sccroll_spanAVX2(const uint8_t* restrict a, const uint8_t* restrict b, size_t size, bool equal)
+{
+    size_t i = 0;
+    uint32_t mask = 0;
+    for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+        mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+            _mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i))
+        ));
+        if ((mask = equal ? ~mask : mask)) return i + __builtin_ctz(mask);
+    }
+    return i + sccroll_spanSSE2(a + i, b + i, size - i, equal);
+}
+
+static size_t sccroll_spanAVX512(const uint8_t* restrict a, const uint8_t* restrict b, size_t size, bool equal)
+{
+    size_t i = 0;
+    uint64_t mask = 0;
+    for (; i + sizeof(__m512i) <= size; i += sizeof(__m512i)) {
+        mask = _mm512_cmpeq_epi8_mask(
+            _mm512_loadu_si512((const void*)(a + i)), _mm512_loadu_si512((const void*)(b + i))
+        );
+        if ((mask = equal ? ~mask : mask)) return i + __builtin_ctzll(mask);
+    }
+    return i + sccroll_spanAVX2(a + i, b + i, size - i, equal);
+}
+#endif // SCCSIMD
+
+// clang-format off
+
+/******************************************************************************
+ * Data hashing
+ ******************************************************************************/
+// clang-format on
+
+static void sccroll_hashCompress(
+    const uint32_t cv[8], const uint8_t block[SCCHASHBLOCK], uint64_t counter,
+    uint32_t blocklen, uint32_t flags, uint32_t out[16]
+)
+{
+    static const uint8_t permutation[16] = { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 };
+    uint32_t m[16], tmp[16];
+    uint32_t* v = out;
+
+#define rotr(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define mix(a, b, c, d, x, y)                               \
+    do {                                                    \
+        v[a] += v[b] + (x); v[d] = rotr(v[d] ^ v[a], 16);   \
+        v[c] += v[d];       v[b] = rotr(v[b] ^ v[c], 12);   \
+        v[a] += v[b] + (y); v[d] = rotr(v[d] ^ v[a], 8);    \
+        v[c] += v[d];       v[b] = rotr(v[b] ^ v[c], 7);    \
+    } while (0)
+
+    for (int i = 0; i < 16; ++i)
+        m[i] = (uint32_t)block[4*i] | (uint32_t)block[4*i+1] << 8
+            | (uint32_t)block[4*i+2] << 16 | (uint32_t)block[4*i+3] << 24;
+
+    memcpy(v, cv, sizeof(uint32_t) * 8);
+    memcpy(v + 8, IV, sizeof(uint32_t) * 4);
+    v[12] = (uint32_t)counter;
+    v[13] = (uint32_t)(counter >> 32);
+    v[14] = blocklen;
+    v[15] = flags;
+
+    for (int round = 0; round < 7; ++round) {
+        mix(0, 4,  8, 12, m[0],  m[1]);
+        mix(1, 5,  9, 13, m[2],  m[3]);
+        mix(2, 6, 10, 14, m[4],  m[5]);
+        mix(3, 7, 11, 15, m[6],  m[7]);
+        mix(0, 5, 10, 15, m[8],  m[9]);
+        mix(1, 6, 11, 12, m[10], m[11]);
+        mix(2, 7,  8, 13, m[12], m[13]);
+        mix(3, 4,  9, 14, m[14], m[15]);
+        for (int i = 0; i < 16; ++i) tmp[i] = m[permutation[i]];
+        memcpy(m, tmp, sizeof(m));
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        v[i] ^= v[i + 8];
+        v[i + 8] ^= cv[i];
+    }
+#undef mix
+#undef rotr
+}
+
+static void sccroll_hashBlock(const uint32_t left[8], const uint32_t right[8], uint8_t block[SCCHASHBLOCK])
+{
+    for (int i = 0; i < 8; ++i)
+        for (int b = 0; b < 4; ++b) {
+            block[4*i + b]      = left[i] >> (8*b);
+            block[32 + 4*i + b] = right[i] >> (8*b);
+        }
+}
+
+void sccroll_hashInit(SccrollHash* restrict hash)
+{
+    memset(hash, 0, sizeof(SccrollHash));
+    memcpy(hash->cv, IV, sizeof(IV));
+}
+
+void sccroll_hashUpdate(SccrollHash* restrict hash, const void* restrict blob, size_t size)
+{
+    const uint8_t* bytes = blob;
+    uint8_t block[SCCHASHBLOCK];
+    uint32_t out[16];
+    uint64_t total = 0;
+    size_t take = 0;
+
+    while (size) {
+        // A full chunk is only compressed once more input comes, as
+        // the last one must be flagged as the root.
+        if (hash->blocks * SCCHASHBLOCK + hash->blocklen == SCCHASHCHUNK) {
+            sccroll_hashCompress(hash->cv, hash->block, hash->chunks, hash->blocklen,
+                                 CHUNKEND | (hash->blocks ? 0 : CHUNKSTART), out);
+            // Merge the completed subtrees, one per trailing 0 bit of
+            // the total number of chunks.
+            for (total = ++hash->chunks; !(total & 1); total >>= 1) {
+                sccroll_hashBlock(hash->stack[--hash->stacklen], out, block);
+                sccroll_hashCompress(IV, block, 0, SCCHASHBLOCK, PARENT, out);
+            }
+            memcpy(hash->stack[hash->stacklen++], out, sizeof(uint32_t) * 8);
+            memcpy(hash->cv, IV, sizeof(IV));
+            hash->blocks = hash->blocklen = 0;
+        }
+
+        if (hash->blocklen == SCCHASHBLOCK) {
+            sccroll_hashCompress(hash->cv, hash->block, hash->chunks, SCCHASHBLOCK,
+                                 hash->blocks ? 0 : CHUNKSTART, out);
+            memcpy(hash->cv, out, sizeof(uint32_t) * 8);
+            ++hash->blocks;
+            hash->blocklen = 0;
+        }
+
+        take = SCCHASHBLOCK - hash->blocklen;
+        take = take < size ? take : size;
+        memcpy(hash->block + hash->blocklen, bytes, take);
+        hash->blocklen += take;
+        bytes += take;
+        size -= take;
+    }
+}
+
+char* sccroll_hashFinal(const SccrollHash* restrict hash, char hex[SCCHASHHEX])
+{
+    uint8_t block[SCCHASHBLOCK] = { 0 };
+    uint32_t cv[8], out[16];
+    uint32_t flags    = CHUNKEND | (hash->blocks ? 0 : CHUNKSTART);
+    uint32_t blocklen = hash->blocklen;
+    uint64_t counter  = hash->chunks;
+    int stacklen      = hash->stacklen;
+
+    memcpy(cv, hash->cv, sizeof(cv));
+    memcpy(block, hash->block, hash->blocklen);
+    // Fold the stacked subtrees from the right, the last parent being
+    // the root.
+    while (stacklen--) {
+        sccroll_hashCompress(cv, block, counter, blocklen, flags, out);
+        sccroll_hashBlock(hash->stack[stacklen], out, block);
+        memcpy(cv, IV, sizeof(cv));
+        counter  = 0;
+        blocklen = SCCHASHBLOCK;
+        flags    = PARENT;
+    }
+    sccroll_hashCompress(cv, block, counter, blocklen, flags | ROOT, out);
+
+    for (int i = 0; i < SCCHASHSIZE; ++i)
+        sprintf(hex + 2*i, "%02x", (out[i / 4] >> (8 * (i % 4))) & 0xFF);
+    return hex;
+}
+
+char* sccroll_hash(const void* restrict blob, size_t size, char hex[SCCHASHHEX])
+{
+    SccrollHash hash;
+    sccroll_hashInit(&hash);
+    if (blob) sccroll_hashUpdate(&hash, blob, size);
+    return sccroll_hashFinal(&hash, hex);
+}
+
+long long sccroll_hashFile(FILE* restrict stream, char hex[SCCHASHHEX])
+{
+    char buffer[BUFSIZ * 8];
+    long long total = 0;
+    size_t size = 0;
+    SccrollHash hash;
+    sccroll_hashInit(&hash);
+    while ((size = fread(buffer, sizeof(char), sizeof(buffer), stream))) {
+        sccroll_hashUpdate(&hash, buffer, size);
+        total += size;
+    }
+    if (ferror(stream)) return -1;
+    sccroll_hashFinal(&hash, hex);
+    return total;
+}
@@ -0,0 +1,901 @@
+/**
+ * @file        fuzz.c
+ * @version     0.1.0
+ * @brief       Fuzzing module source code.
+ * @author      Alexandre Martos
+ * @email       contact@amartos.fr
+ * @copyright   2022-2023 Alexandre Martos <contact@amartos.fr>
+ * @license     MIT License
+ *
+ * @addtogroup Internals
+ * @{
+ * @addtogroup Fuzz Fuzzing module internals.
+ * @{
+ */
+
+#include "sccroll/fuzz.h"
+
+// clang-format off
+
+/******************************************************************************
+ * @name Reports
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @def CRASHFMT
+ * @since 0.1.0
+ * @brief Crash report format string, styled as the core reports.
+ * @param s The test name.
+ * @param s The signal name.
+ * @param s The saved input path.
+ */
+#define CRASHFMT "[ \e[0;1;31mCRASH\e[0m ] %s: SIG%s, input saved in %s\n"
+
+/**
+ * @def FUZZFMT
+ * @since 0.1.0
+ * @brief Fuzzing summary format string, styled as the core reports.
+ * @param s The test name.
+ * @param u The number of executed inputs.
+ * @param i The corpus size.
+ * @param u The number of covered edges.
+ * @param i The number of crashes.
+ */
+#define FUZZFMT "[ \e[0;1;36mFUZZ\e[0m ] %s: %u runs, %i inputs, %u edges, %i crashes\n"
+
+/**
+ * @def MINFMT
+ * @since 0.1.0
+ * @brief Corpus minimization summary format string.
+ * @param s The test name.
+ * @param i The corpus size.
+ * @param i The number of distinct non-crashing inputs.
+ * @param i The minimized corpus size.
+ * @param zu The number of inputs skipped as too long.
+ */
+#define MINFMT "[ \e[0;1;36mCMIN\e[0m ] %s: %i inputs, %i distinct, %i kept, %zu too long\n"
+
+// clang-format off
+
+/******************************************************************************
+ * @}
+ * @name Coverage map
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @var edges
+ * @since 0.1.0
+ * @brief Hit counts of the coverage edges of the last execution.
+ *
+ * This map is shared with the forks executing the tests, and only
+ * exists during a sccroll_fuzz() call; the coverage callbacks do
+ * nothing otherwise.
+ */
+static unsigned char* edges = NULL;
+
+/**
+ * @var location
+ * @since 0.1.0
+ * @brief The previous location hash used to identify the edges with
+ * GCC instrumentation.
+ */
+static __thread uintptr_t location = 0;
+
+/**
+ * @since 0.1.0
+ * @brief Map the coverage edges shared memory.
+ */
+static void sccroll_fuzzMap(void);
+
+/**
+ * @since 0.1.0
+ * @brief Unmap the coverage edges shared memory.
+ */
+static void sccroll_fuzzUnmap(void);
+
+/**
+ * @since 0.1.0
+ * @brief Give the hit count class of a coverage edge.
+ *
+ * The classes are the same as the ones used by AFL: 1, 2, 3, 4-7,
+ * 8-15, 16-31, 32-127 and 128+ hits. Each class is a different bit.
+ *
+ * @param count The edge hit count.
+ * @return The hit count class bit, or @c 0 if @p count is @c 0.
+ */
+static unsigned char sccroll_fuzzClass(unsigned char count) __attribute__((const));
+
+/**
+ * @since 0.1.0
+ * @brief Check if the last execution reached new edges or edges hit
+ * counts classes.
+ * @param virgin The classes not reached yet for each edge. The
+ * classes reached by the last execution are removed from it.
+ * @return @c true if the last execution coverage is new, @c false
+ * otherwise.
+ */
+static bool sccroll_fuzzNovel(unsigned char virgin[SCCMAPSIZE]) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Count the edges reached at least once.
+ * @param virgin The classes not reached yet for each edge.
+ * @return The number of reached edges.
+ */
+static unsigned sccroll_fuzzEdges(const unsigned char virgin[SCCMAPSIZE]) __attribute__((nonnull));
+
+// clang-format off
+
+/******************************************************************************
+ * @}
+ * @name Inputs handling
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @enum SccrollMutations
+ * @since 0.1.0
+ * @brief Mutations applied to the inputs.
+ */
+typedef enum SccrollMutations {
+    MUTFLIP,   /**< Flip a bit. */
+    MUTBYTE,   /**< Set a byte to a random value. */
+    MUTMAGIC,  /**< Set a byte to an interesting value. */
+    MUTINSERT, /**< Insert a random byte. */
+    MUTDELETE, /**< Delete a byte. */
+    MUTTOKEN,  /**< Insert or overwrite with a dictionary token. */
+    MUTSPLICE, /**< Splice with another input of the corpus. */
+    MUTMAX,    /**< Number of mutations. */
+    MUTSTACK = 4, /**< Max number of mutations stacked on a input. */
+} SccrollMutations;
+
+/**
+ * @since 0.1.0
+ * @brief Read an input file.
+ * @param path The file path.
+ * @return A malloc'ed Data storing the first #SCCMAXINPUT bytes of
+ * the file, followed by a null byte not counted in Data::size.
+ */
+static Data* sccroll_fuzzRead(const char* restrict path) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Load the inputs of a corpus directory.
+ * @param corpus The corpus directory path, or @c NULL.
+ * @param skipped If not @c NULL, the inputs longer than #SCCMAXINPUT
+ * bytes are not loaded but counted in it; otherwise they are
+ * truncated.
+ * @return A List of Data, or @c NULL if @p corpus is @c NULL, does
+ * not exist or is empty.
+ */
+static List* sccroll_fuzzLoad(const char* restrict corpus, size_t* restrict skipped);
+
+/**
+ * @since 0.1.0
+ * @brief Free a corpus.
+ * @param corpus The list of inputs to free.
+ */
+static void sccroll_fuzzFree(List* restrict corpus) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Apply random stacked mutations to an input.
+ * @param input The input to mutate. Its Data::blob must be at least
+ * #SCCMAXINPUT + 1 bytes long.
+ * @param corpus The corpus used for splices.
+ * @param dict The dictionary tokens, or @c NULL.
+ */
+static void sccroll_fuzzMutate(Data* restrict input, List* restrict corpus, const char** dict)
+    __attribute__((nonnull(1, 2)));
+
+/**
+ * @since 0.1.0
+ * @brief Hash a blob (FNV-1a, 64 bits).
+ * @param blob The blob to hash.
+ * @param size The @p blob size.
+ * @return The hash value.
+ */
+static uint64_t sccroll_fuzzHash(const void* restrict blob, size_t size);
+
+/**
+ * @since 0.1.0
+ * @brief Save an input in a directory.
+ * @param dir The destination directory, created if needed.
+ * @param name The test name.
+ * @param input The input to save.
+ * @param path A #SCCMAX buffer storing the saved file path.
+ * @return @c true if a new file was written, @c false if the input
+ * was already saved.
+ */
+static bool sccroll_fuzzSave(const char* restrict dir, const char* restrict name, const Data* restrict input, char* restrict path)
+    __attribute__((nonnull));
+
+// clang-format off
+
+/******************************************************************************
+ * @}
+ * @name Execution
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @struct SccrollFuzzTrace
+ * @since 0.1.0
+ * @brief The coverage tuples of an input.
+ *
+ * A tuple is an edge index combined with its hit count class (see
+ * sccroll_fuzzClass()), as @c edge*CHAR_BIT + @c log2(class).
+ */
+typedef struct SccrollFuzzTrace {
+    const Data* input; /**< The input. */
+    uint32_t* tuples;  /**< The tuples reached by the input. */
+    size_t len;        /**< The number of tuples. */
+} SccrollFuzzTrace;
+
+/**
+ * @since 0.1.0
+ * @brief Prepare a fuzzing session.
+ * @param effects The test to fuzz.
+ * @param options The fuzzing options.
+ * @return A malloc'ed copy of @p effects ready to be fuzzed.
+ */
+static SccrollEffects* sccroll_fuzzStart(const SccrollEffects* restrict effects, const SccrollFuzz* restrict options)
+    __attribute__((nonnull, returns_nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief End a fuzzing session.
+ * @param test The test returned by sccroll_fuzzStart(), freed.
+ * @param options The fuzzing options.
+ */
+static void sccroll_fuzzEnd(SccrollEffects* restrict test, const SccrollFuzz* restrict options)
+    __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Execute the test with the given input and record its
+ * coverage.
+ * @param test The test to execute.
+ * @param input The input to feed to the test.
+ * @param options The fuzzing options.
+ * @return The signal which terminated the test, or @c 0.
+ */
+static int sccroll_fuzzRun(SccrollEffects* restrict test, const Data* restrict input, const SccrollFuzz* restrict options)
+    __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Record the coverage tuples of the last execution.
+ * @param trace The trace to fill.
+ */
+static void sccroll_fuzzTrace(SccrollFuzzTrace* restrict trace) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Execute the test with the given input and sort the input.
+ * @param test The test to execute.
+ * @param input The input to feed to the test. The byte following its
+ * content must be writable.
+ * @param options The fuzzing options.
+ * @param virgin The classes not reached yet for each edge.
+ * @param corpus The corpus to add the input to if its coverage is
+ * new, or @c NULL to only record the coverage.
+ * @param crashed The content hashes of the crashing inputs already
+ * found, used and extended if SccrollFuzz::crashes is @c NULL.
+ * @return @c 1 if the input is a new crashing input, @c 0 otherwise.
+ */
+static int sccroll_fuzzCheck(
+    SccrollEffects* restrict test, Data* restrict input, const SccrollFuzz* restrict options,
+    unsigned char virgin[SCCMAPSIZE], List* restrict corpus, List** restrict crashed
+) __attribute__((nonnull(1, 2, 3, 4, 6)));
+
+// clang-format off
+
+/******************************************************************************
+ * @}
+ * @name Persistent mode
+ * @{
+ ******************************************************************************/
+// clang-format on
+
+/**
+ * @struct SccrollFuzzChild
+ * @since 0.1.0
+ * @brief A persistent child executing the test wrapper in a loop.
+ */
+typedef struct SccrollFuzzChild {
+    pid_t pid;            /**< The child pid, or @c 0 if there is none. */
+    int input;            /**< Write end of the inputs pipe. */
+    int done;             /**< Read end of the iterations pipe. */
+    unsigned count;       /**< Number of inputs executed by the child. */
+    sighandler_t sigpipe; /**< The original #SIGPIPE handler. */
+} SccrollFuzzChild;
+
+/**
+ * @var child
+ * @since 0.1.0
+ * @brief The current persistent child.
+ */
+static SccrollFuzzChild child = { 0 };
+
+/**
+ * @since 0.1.0
+ * @brief Fork a new persistent child.
+ * @param test The test executed by the child.
+ */
+static void sccroll_fuzzSpawn(const SccrollEffects* restrict test) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Persistent child loop.
+ *
+ * Each input is received on @p input as its size followed by its
+ * content, and written in a new pipe used as the standard input of
+ * the test wrapper. The input size is sent back on @p done once the
+ * wrapper returns. The loop ends when @p input is closed.
+ *
+ * @param test The test to execute.
+ * @param input The inputs pipe read end.
+ * @param done The iterations pipe write end.
+ */
+static void sccroll_fuzzLoop(const SccrollEffects* restrict test, int input, int done)
+    __attribute__((nonnull, noreturn));
+
+/**
+ * @since 0.1.0
+ * @brief Stop the persistent child.
+ * @return The signal which terminated the child, or @c 0.
+ */
+static int sccroll_fuzzStop(void);
+
+/**
+ * @since 0.1.0
+ * @brief Execute the test with the given input in the persistent
+ * child, forking it if needed.
+ * @param test The test to execute.
+ * @param input The input to feed to the test.
+ * @param persist The number of inputs after which the child is
+ * stopped.
+ * @return The signal which terminated the child during the input
+ * execution, or @c 0.
+ */
+static int sccroll_fuzzPersist(const SccrollEffects* restrict test, const Data* restrict input, unsigned persist)
+    __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Write a whole blob in a pipe.
+ * @param fd The pipe write end.
+ * @param blob The blob to write.
+ * @param size The @p blob size.
+ * @return @c false if the pipe read end is closed, @c true otherwise.
+ */
+static bool sccroll_fuzzSend(int fd, const void* restrict blob, size_t size);
+
+/**
+ * @since 0.1.0
+ * @brief Read a whole blob from a pipe.
+ * @param fd The pipe read end.
+ * @param blob The buffer storing the blob.
+ * @param size The @p blob size.
+ * @return @c false if the pipe write end is closed before the end of
+ * the blob, @c true otherwise.
+ */
+static bool sccroll_fuzzRecv(int fd, void* restrict blob, size_t size);
+
+// clang-format off
+
+/******************************************************************************
+ * @}
+ *
+ * Implementation
+ *
+ * Coverage
+ ******************************************************************************/
+// clang-format on
+
+static void sccroll_fuzzMap(void)
+{
+    edges = mmap(NULL, SCCMAPSIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (edges == MAP_FAILED) err(EXIT_FAILURE, "could not map the coverage edges");
+}
+
+static void sccroll_fuzzUnmap(void)
+{
+    unsigned char* map = edges;
+    edges = NULL;
+    munmap(map, SCCMAPSIZE);
+}
+
+void __sanitizer_cov_trace_pc_guard_init(uint32_t* start, uint32_t* stop)
+{
+    static uint32_t count = 0;
+    if (start == stop || *start) return;
+    for (uint32_t* guard = start; guard < stop; ++guard) *guard = ++count;
+}
+
+void __sanitizer_cov_trace_pc_guard(uint32_t* guard)
+{
+    if (edges && *guard) ++edges[*guard % SCCMAPSIZE];
+}
+
+void __sanitizer_cov_trace_pc(void)
+{
+    if (!edges) return;
+    // Same edges identification as AFL: the current location is
+    // xor'ed with the previous one, shifted to distinguish A->B from
+    // B->A.
+    uintptr_t current = (uintptr_t)__builtin_return_address(0);
+    current = (current >> 4) ^ (current << 8);
+    ++edges[(current ^ location) % SCCMAPSIZE];
+    location = current >> 1;
+}
+
+static unsigned char sccroll_fuzzClass(unsigned char count)
+{
+    if (count < 4) return count == 3 ? 4 : count;
+    if (count < 8) return 8;
+    if (count < 16) return 16;
+    if (count < 32) return 32;
+    if (count < 128) return 64;
+    return 128;
+}
+
+static bool sccroll_fuzzNovel(unsigned char virgin[SCCMAPSIZE])
+{
+    bool novel = false;
+    unsigned char class;
+    for (int i = 0; i < SCCMAPSIZE; ++i) {
+        if (!edges[i] || !(class = sccroll_fuzzClass(edges[i]) & virgin[i])) continue;
+        virgin[i] &= ~class;
+        novel = true;
+    }
+    return novel;
+}
+
+static unsigned sccroll_fuzzEdges(const unsigned char virgin[SCCMAPSIZE])
+{
+    unsigned count = 0;
+    for (int i = 0; i < SCCMAPSIZE; ++i) count += virgin[i] != 0xFF;
+    return count;
+}
+
+// clang-format off
+
+/******************************************************************************
+ * Inputs
+ ******************************************************************************/
+// clang-format on
+
+static Data* sccroll_fuzzRead(const char* restrict path)
+{
+    char buffer[SCCMAXINPUT + 1] = { 0 };
+    size_t size = 0;
+    FILE* stream = fopen(path, "rb");
+    if (!stream) err(EXIT_FAILURE, "could not open input %s", path);
+    if (!(size = fread(buffer, sizeof(char), SCCMAXINPUT, stream)) && ferror(stream))
+        err(EXIT_FAILURE, "could not read input %s", path);
+    fclose(stream);
+    return mkdata(blobdup(buffer, size+sizeof(char)), size, 0);
+}
+
+static List* sccroll_fuzzLoad(const char* restrict corpus, size_t* restrict skipped)
+{
+    char path[SCCMAX] = { 0 };
+    struct stat status = { 0 };
+    struct dirent* entry = NULL;
+    List* inputs = NULL;
+    DIR* dir = corpus ? opendir(corpus) : NULL;
+    if (!dir) return inputs;
+    while ((entry = readdir(dir))) {
+        if (entry->d_type != DT_REG) continue;
+        snprintf(path, SCCMAX, "%s/%s", corpus, entry->d_name);
+        if (skipped && !stat(path, &status) && status.st_size > SCCMAXINPUT) {
+            ++*skipped;
+            continue;
+        }
+        inputs = lappend(sccroll_fuzzRead(path), inputs);
+    }
+    closedir(dir);
+    return inputs;
+}
+
+static void sccroll_fuzzFree(List* restrict corpus)
+{
+    Data* input = NULL;
+    while ((input = lpop(corpus))) {
+        free(input->blob);
+        free(input);
+    }
+    lfree(corpus);
+}
+
+static void sccroll_fuzzMutate(Data* restrict input, List* restrict corpus, const char** dict)
+{
+    static const unsigned char magic[] = { 0x00, 0x01, 0x7F, 0x80, 0xFF, '\n', ' ', '0' };
+    unsigned char* bytes = input->blob;
+    const Data* other    = NULL;
+    const char* token    = NULL;
+    size_t tokens = 0, pos = 0, length = 0;
+
+    while (dict && dict[tokens]) ++tokens;
+
+    for (int stack = 1 + random() % MUTSTACK; stack; --stack) {
+        pos = input->size ? random() % input->size : 0;
+        switch (random() % MUTMAX)
+        {
+        case MUTFLIP:
+            if (input->size) bytes[pos] ^= 1 << (random() % 8);
+            break;
+        case MUTBYTE:
+            if (input->size) bytes[pos] = random() & 0xFF;
+            break;
+        case MUTMAGIC:
+            if (input->size) bytes[pos] = magic[random() % sizeof(magic)];
+            break;
+        case MUTINSERT:
+            if (input->size >= SCCMAXINPUT) break;
+            pos = random() % (input->size + 1);
+            memmove(bytes+pos+1, bytes+pos, input->size-pos);
+            bytes[pos] = random() & 0xFF;
+            ++input->size;
+            break;
+        case MUTDELETE:
+            if (!input->size) break;
+            memmove(bytes+pos, bytes+pos+1, input->size-pos-1);
+            --input->size;
+            break;
+        case MUTTOKEN:
+            if (!tokens) break;
+            token  = dict[random() % tokens];
+            length = strlen(token);
+            pos    = random() % (input->size + 1);
+            if (pos + length > SCCMAXINPUT) break;
+            // Insert half of the time, overwrite otherwise.
+            if (random() % 2 && input->size + length <= SCCMAXINPUT) {
+                memmove(bytes+pos+length, bytes+pos, input->size-pos);
+                input->size += length;
+            }
+            memcpy(bytes+pos, token, length);
+            if (pos + length > input->size) input->size = pos + length;
+            break;
+        case MUTSPLICE:
+            other  = lidx(random() % corpus->len, corpus)->data;
+            length = other->size ? random() % other->size : 0;
+            if (pos + other->size - length > SCCMAXINPUT) break;
+            memcpy(bytes+pos, (char*)other->blob+length, other->size-length);
+            input->size = pos + other->size - length;
+            break;
+        default: break;
+        }
+    }
+    bytes[input->size] = 0;
+}
+
+static uint64_t sccroll_fuzzHash(const void* restrict blob, size_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= ((const unsigned char*)blob)[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static bool sccroll_fuzzSave(const char* restrict dir, const char* restrict name, const Data* restrict input, char* restrict path)
+{
+    if (mkdir(dir, S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH) < 0 && errno != EEXIST)
+        err(EXIT_FAILURE, "could not create directory %s", dir);
+
+    int length = snprintf(path, SCCMAX, "%s/", dir);
+    // The test name may not be a valid file name.
+    for (; *name && length < SCCMAX - 18; ++name, ++length)
+        path[length] = *name == '/' || isspace(*name) ? '_' : *name;
+    snprintf(path+length, SCCMAX-length, "-%016" PRIx64, sccroll_fuzzHash(input->blob, input->size));
+    if (!access(path, F_OK)) return false;
+
+    FILE* stream = fopen(path, "wb");
+    if (!stream) err(EXIT_FAILURE, "could not open %s", path);
+    if (fwrite(input->blob, sizeof(char), input->size, stream) != input->size && ferror(stream))
+        err(EXIT_FAILURE, "could not write %s", path);
+    fclose(stream);
+    return true;
+}
+
+// clang-format off
+
+/******************************************************************************
+ * Execution
+ ******************************************************************************/
+// clang-format on
+
+int sccroll_fuzz(const SccrollEffects* restrict effects, const SccrollFuzz* restrict options)
+{
+    int crashes = 0;
+    unsigned char virgin[SCCMAPSIZE];
+    char buffer[SCCMAXINPUT + 1] = { 0 };
+    Data input = { .blob = buffer };
+    const Data* parent = NULL;
+
+    SccrollEffects* test = sccroll_fuzzStart(effects, options);
+    memset(virgin, 0xFF, SCCMAPSIZE);
+    if (options->seed) srandom(options->seed);
+
+    List* corpus = sccroll_fuzzLoad(options->corpus, NULL);
+    if (!corpus) corpus = lappend(mkdata(blobdup(NULL, sizeof(char)), 0, 0), NULL);
+    List* crashed = NULL;
+
+    // The initial corpus is only executed to record its coverage.
+    for (Node* node = corpus->head; node; node = node->next)
+        crashes += sccroll_fuzzCheck(test, node->data, options, virgin, NULL, &crashed);
+
+    for (unsigned run = 0; run < options->runs; ++run) {
+        parent = lidx(random() % corpus->len, corpus)->data;
+        memcpy(buffer, parent->blob, parent->size);
+        input.size = parent->size;
+        sccroll_fuzzMutate(&input, corpus, options->dict);
+        crashes += sccroll_fuzzCheck(test, &input, options, virgin, corpus, &crashed);
+    }
+
+    if (!sccroll_hasFlags(effects->flags, NODIFF))
+        fprintf(stderr, FUZZFMT, effects->name, options->runs, corpus->len, sccroll_fuzzEdges(virgin), crashes);
+
+    sccroll_fuzzEnd(test, options);
+    sccroll_fuzzFree(corpus);
+    if (crashed) sccroll_fuzzFree(crashed);
+    return crashes;
+}
+
+int sccroll_minimize(const SccrollEffects* restrict effects, const SccrollFuzz* restrict options, const char* restrict output)
+{
+    char path[SCCMAX] = { 0 };
+    int kept = 0, len = 0;
+    uint32_t tuple = 0;
+    size_t skipped = 0;
+    // The kept inputs are saved from their loaded copies, thus the
+    // truncated ones would be corrupted.
+    List* corpus = sccroll_fuzzLoad(options->corpus, &skipped);
+    if (!corpus) return 0;
+
+    SccrollEffects* test      = sccroll_fuzzStart(effects, options);
+    SccrollFuzzTrace* traces  = calloc(corpus->len, sizeof(SccrollFuzzTrace));
+    uint64_t* hashes          = calloc(corpus->len, sizeof(uint64_t));
+    int* best                 = calloc(SCCMAPSIZE * CHAR_BIT, sizeof(int));
+    unsigned char* covered    = calloc(SCCMAPSIZE * CHAR_BIT, sizeof(char));
+    bool* selected            = calloc(corpus->len, sizeof(bool));
+    if (!traces || !hashes || !best || !covered || !selected)
+        err(EXIT_FAILURE, "could not allocate the minimization of %s", options->corpus);
+
+    for (Node* node = corpus->head; node; node = node->next) {
+        const Data* input = node->data;
+        uint64_t hash = sccroll_fuzzHash(input->blob, input->size);
+        bool duplicate = false;
+        for (int i = 0; i < len && !duplicate; ++i)
+            duplicate = hashes[i] == hash
+                && traces[i].input->size == input->size
+                && blobspan(traces[i].input->blob, input->blob, input->size, true) == input->size;
+        // Crashing inputs do not belong to a corpus.
+        if (duplicate || sccroll_fuzzRun(test, input, options)) continue;
+
+        hashes[len] = hash;
+        traces[len].input = input;
+        sccroll_fuzzTrace(&traces[len]);
+        // The best input of each tuple is the smallest one; best
+        // stores the index + 1 to keep 0 for "none".
+        for (size_t t = 0; t < traces[len].len; ++t) {
+            tuple = traces[len].tuples[t];
+            if (!best[tuple] || traces[best[tuple]-1].input->size > input->size)
+                best[tuple] = len + 1;
+        }
+        ++len;
+    }
+
+    for (tuple = 0; tuple < SCCMAPSIZE * CHAR_BIT; ++tuple) {
+        if (!best[tuple] || covered[tuple] || selected[best[tuple]-1]) continue;
+        const SccrollFuzzTrace* trace = &traces[best[tuple]-1];
+        selected[best[tuple]-1] = true;
+        for (size_t t = 0; t < trace->len; ++t) covered[trace->tuples[t]] = 1;
+        sccroll_fuzzSave(output, test->name, trace->input, path);
+        ++kept;
+    }
+
+    if (!sccroll_hasFlags(effects->flags, NODIFF))
+        fprintf(stderr, MINFMT, effects->name, corpus->len, len, kept, skipped);
+
+    for (int i = 0; i < len; ++i) free(traces[i].tuples);
+    free(traces);
+    free(hashes);
+    free(best);
+    free(covered);
+    free(selected);
+    sccroll_fuzzEnd(test, options);
+    sccroll_fuzzFree(corpus);
+    return kept;
+}
+
+static SccrollEffects* sccroll_fuzzStart(const SccrollEffects* restrict effects, const SccrollFuzz* restrict options)
+{
+    SccrollEffects* test = blobdup(effects, sizeof(SccrollEffects));
+    test->flags = (test->flags | NOSTRP) & ~NOFORK;
+    test->code  = (SccrollCode){ .type = SCCSIGNAL };
+    test->std[STDIN_FILENO].path = NULL;
+
+    sccroll_fuzzMap();
+    // A persistent child dying closes its pipes, which is handled as
+    // a crash rather than a signal.
+    if (options->persist) child.sigpipe = signal(SIGPIPE, SIG_IGN);
+    return test;
+}
+
+static void sccroll_fuzzEnd(SccrollEffects* restrict test, const SccrollFuzz* restrict options)
+{
+    if (options->persist) {
+        if (child.pid) sccroll_fuzzStop();
+        signal(SIGPIPE, child.sigpipe);
+    }
+    sccroll_fuzzUnmap();
+    free(test);
+}
+
+static int sccroll_fuzzRun(SccrollEffects* restrict test, const Data* restrict input, const SccrollFuzz* restrict options)
+{
+    memset(edges, 0, SCCMAPSIZE);
+    location = 0;
+    test->std[STDIN_FILENO].content = *input;
+    return options->persist
+        ? sccroll_fuzzPersist(test, input, options->persist)
+        : sccroll_exec(test).value;
+}
+
+static void sccroll_fuzzTrace(SccrollFuzzTrace* restrict trace)
+{
+    trace->len = 0;
+    for (int i = 0; i < SCCMAPSIZE; ++i) trace->len += edges[i] != 0;
+    if (!trace->len) return;
+    if (!(trace->tuples = calloc(trace->len, sizeof(uint32_t))))
+        err(EXIT_FAILURE, "could not allocate the coverage tuples");
+    for (int i = 0, t = 0; i < SCCMAPSIZE; ++i)
+        if (edges[i]) trace->tuples[t++] = i * CHAR_BIT + __builtin_ctz(sccroll_fuzzClass(edges[i]));
+}
+
+static int sccroll_fuzzCheck(
+    SccrollEffects* restrict test, Data* restrict input, const SccrollFuzz* restrict options,
+    unsigned char virgin[SCCMAPSIZE], List* restrict corpus, List** restrict crashed
+)
+{
+    char path[SCCMAX] = { 0 };
+    uint64_t hash = 0;
+    int signal = sccroll_fuzzRun(test, input, options);
+
+    if (signal && !options->crashes) {
+        // The crashing inputs are told apart by their content hash,
+        // as the saved ones by their file name.
+        hash = sccroll_fuzzHash(input->blob, input->size);
+        for (Node* node = *crashed ? (*crashed)->head : NULL; node; node = node->next)
+            if (*(uint64_t*)((Data*)node->data)->blob == hash) return 0;
+        *crashed = lappend(mkdata(blobdup(&hash, sizeof(hash)), sizeof(hash), 0), *crashed);
+        return 1;
+    }
+    if (signal) {
+        if (!sccroll_fuzzSave(options->crashes, test->name, input, path)) return 0;
+        if (!sccroll_hasFlags(test->flags, NODIFF))
+            fprintf(stderr, CRASHFMT, test->name, sigabbrev_np(signal), path);
+        return 1;
+    }
+
+    if (sccroll_fuzzNovel(virgin) && corpus) {
+        lappend(mkdata(blobdup(input->blob, input->size+sizeof(char)), input->size, 0), corpus);
+        if (options->corpus) sccroll_fuzzSave(options->corpus, test->name, input, path);
+    }
+    return 0;
+}
+
+// clang-format off
+
+/******************************************************************************
+ * Persistent mode
+ ******************************************************************************/
+// clang-format on
+
+static void sccroll_fuzzSpawn(const SccrollEffects* restrict test)
+{
+    int input[2] = { 0 }, done[2] = { 0 };
+    if (pipe(input) < 0 || pipe(done) < 0)
+        err(EXIT_FAILURE, "could not open the persistent pipes of %s", test->name);
+    if ((child.pid = fork()) < 0)
+        err(EXIT_FAILURE, "could not fork the persistent child of %s", test->name);
+    if (!child.pid) {
+        signal(SIGPIPE, child.sigpipe);
+        close(input[1]);
+        close(done[0]);
+        sccroll_fuzzLoop(test, input[0], done[1]);
+    }
+    close(input[0]);
+    close(done[1]);
+    child.input = input[1];
+    child.done  = done[0];
+    child.count = 0;
+}
+
+static void sccroll_fuzzLoop(const SccrollEffects* restrict test, int input, int done)
+{
+    char buffer[SCCMAXINPUT] = { 0 };
+    size_t size = 0;
+    int pipefd[2] = { 0 };
+
+    int null = open("/dev/null", O_WRONLY);
+    if (null < 0 || dup2(null, STDOUT_FILENO) < 0 || dup2(null, STDERR_FILENO) < 0 || close(null) < 0)
+        err(EXIT_FAILURE, "could not discard the standard outputs of %s", test->name);
+
+    while (sccroll_fuzzRecv(input, &size, sizeof(size_t)) && sccroll_fuzzRecv(input, buffer, size)) {
+        if (pipe(pipefd) < 0
+            || !sccroll_fuzzSend(pipefd[1], buffer, size)
+            || close(pipefd[1]) < 0
+            || dup2(pipefd[0], STDIN_FILENO) < 0
+            || close(pipefd[0]) < 0)
+            err(EXIT_FAILURE, "could not reset the standard input of %s", test->name);
+        // Leftovers of the previous input must not be seen.
+        __fpurge(stdin);
+        clearerr(stdin);
+        location = 0;
+        test->wrapper();
+        fflush(stdout);
+        fflush(stderr);
+        if (!sccroll_fuzzSend(done, &size, sizeof(size_t))) break;
+    }
+    exit(EXIT_SUCCESS);
+}
+
+static int sccroll_fuzzStop(void)
+{
+    int status = 0;
+    close(child.input);
+    close(child.done);
+    if (waitpid(child.pid, &status, 0) < 0)
+        err(EXIT_FAILURE, "could not wait for the persistent child");
+    child.pid = 0;
+    return WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+}
+
+static int sccroll_fuzzPersist(const SccrollEffects* restrict test, const Data* restrict input, unsigned persist)
+{
+    size_t size = input->size;
+    if (!child.pid) sccroll_fuzzSpawn(test);
+    if (!sccroll_fuzzSend(child.input, &size, sizeof(size_t))
+        || !sccroll_fuzzSend(child.input, input->blob, size)
+        || !sccroll_fuzzRecv(child.done, &size, sizeof(size_t)))
+        // The child died before the end of the iteration.
+        return sccroll_fuzzStop();
+    if (++child.count >= persist) sccroll_fuzzStop();
+    return 0;
+}
+
+static bool sccroll_fuzzSend(int fd, const void* restrict blob, size_t size)
+{
+    ssize_t sent = 0;
+    for (size_t total = 0; total < size; total += sent)
+        if ((sent = write(fd, (const char*)blob + total, size - total)) < 0) {
+            if (errno == EPIPE) return false;
+            err(EXIT_FAILURE, "could not write in the persistent pipe");
+        }
+    return true;
+}
+
+static bool sccroll_fuzzRecv(int fd, void* restrict blob, size_t size)
+{
+    ssize_t received = 0;
+    for (size_t total = 0; total < size; total += received)
+        if ((received = read(fd, (char*)blob + total, size - total)) <= 0) {
+            if (!received) return false;
+            err(EXIT_FAILURE, "could not read the persistent pipe");
+        }
+    return true;
+}
+
+/** @} @} */
@@ -108,6 +108,80 @@ static SccrollMockTrace trace = {0};
 static bool sccroll_mockCrashTest(SccrollFunc wrapper, SccrollMockFlags mock, unsigned delay)
     __attribute__((nonnull (1)));
 
+/**
+ * @enum SccrollClockSizes
+ * @since 0.1.0
+ * @brief Virtual clock constants.
+ */
+typedef enum SccrollClockSizes {
+    CLOCKMAX  = CLOCK_TAI + 1, /**< Max number of clocks. */
+    CLOCKNSEC = 1000000000,    /**< Number of nanoseconds in a second. */
+} SccrollClockSizes;
+
+/**
+ * @var clocks
+ * @since 0.1.0
+ * @brief The virtual clock state.
+ */
+static struct {
+    bool enabled;                   /**< Whether the clock is virtual. */
+    unsigned long long elapsed;     /**< The nanoseconds elapsed since the clock is virtual. */
+    bool frozen[CLOCKMAX];          /**< Whether each clock is virtual. */
+    struct timespec base[CLOCKMAX]; /**< The real time of each clock when switched to virtual. */
+} clocks = { 0 };
+
+/**
+ * @since 0.1.0
+ * @brief Check if a clock is virtual.
+ * @param clockid The clock.
+ * @return @c true if @p clockid is virtual, @c false otherwise.
+ */
+static bool sccroll_clockIs(clockid_t clockid);
+
+/**
+ * @since 0.1.0
+ * @brief Give the time of a virtual clock.
+ * @param clockid The virtual clock.
+ * @param tp The clock time.
+ * @return @c 0.
+ */
+static int sccroll_clockRead(clockid_t clockid, struct timespec* tp) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Virtual counterpart of time().
+ */
+static time_t sccroll_clockTime(time_t* tloc);
+
+/**
+ * @since 0.1.0
+ * @brief Virtual counterpart of gettimeofday(), without timezone.
+ */
+static int sccroll_clockTimeofday(struct timeval* tv) __attribute__((nonnull));
+
+/**
+ * @since 0.1.0
+ * @brief Virtual counterpart of clock_nanosleep(), which advances
+ * the virtual clock instead of waiting.
+ */
+static int sccroll_clockSleep(clockid_t clockid, int flags, const struct timespec* req, struct timespec* rem)
+    __attribute__((nonnull(3)));
+
+/**
+ * @since 0.1.0
+ * @brief Virtual counterpart of poll(), which advances the virtual
+ * clock of the timeout if no descriptor is ready.
+ */
+static int sccroll_clockPoll(struct pollfd* fds, nfds_t nfds, int timeout);
+
+/**
+ * @since 0.1.0
+ * @brief Virtual counterpart of select(), which advances the virtual
+ * clock of the timeout if no descriptor is ready.
+ */
+static int sccroll_clockSelect(int nfds, fd_set* readfds, fd_set* writefds, fd_set* exceptfds, struct timeval* timeout)
+    __attribute__((nonnull(5)));
+
 // clang-format off
 
 /******************************************************************************
@@ -248,7 +322,7 @@ static bool sccroll_mockCrashTest(SccrollFunc wrapper, SccrollMockFlags mock, un
     // Check that no errors have been raised while no mock is
     // triggered, or that no signals have been sent (SIGABRT, SIGSEGV,
     // ...).
-    assertMsg(
+    sccroll_assert(
         !signal && (!sccroll_mockIsIgnored(mock) || !error),
         "Predefined %s mock error (status %i, signal %s)",
         name,
@@ -372,6 +446,149 @@ SCCROLL_MOCK(
     item, action
 );
 
+// clang-format off
+
+/******************************************************************************
+ * Virtual clock
+ ******************************************************************************/
+// clang-format on
+
+void sccroll_mockClock(bool enabled)
+{
+    // The clocks bases are read while the clock is still real.
+    if (enabled && !clocks.enabled) {
+        clocks.elapsed = 0;
+        for (clockid_t id = 0; id < CLOCKMAX; ++id)
+            clocks.frozen[id] = id != CLOCK_PROCESS_CPUTIME_ID && id != CLOCK_THREAD_CPUTIME_ID
+                && !sccroll_mockclock_gettime(id, &clocks.base[id]);
+    }
+    clocks.enabled = enabled;
+}
+
+void sccroll_mockAdvance(unsigned long long nsec)
+{
+    if (clocks.enabled) clocks.elapsed += nsec;
+}
+
+static bool sccroll_clockIs(clockid_t clockid)
+{
+    return clocks.enabled && clockid >= 0 && clockid < CLOCKMAX && clocks.frozen[clockid];
+}
+
+static int sccroll_clockRead(clockid_t clockid, struct timespec* tp)
+{
+    unsigned long long nsec = clocks.base[clockid].tv_nsec + clocks.elapsed;
+    tp->tv_sec  = clocks.base[clockid].tv_sec + nsec / CLOCKNSEC;
+    tp->tv_nsec = nsec % CLOCKNSEC;
+    return 0;
+}
+
+static time_t sccroll_clockTime(time_t* tloc)
+{
+    struct timespec now = { 0 };
+    sccroll_clockRead(CLOCK_REALTIME, &now);
+    if (tloc) *tloc = now.tv_sec;
+    return now.tv_sec;
+}
+
+static int sccroll_clockTimeofday(struct timeval* tv)
+{
+    struct timespec now = { 0 };
+    sccroll_clockRead(CLOCK_REALTIME, &now);
+    *tv = (struct timeval){ .tv_sec = now.tv_sec, .tv_usec = now.tv_nsec / 1000 };
+    return 0;
+}
+
+static int sccroll_clockSleep(clockid_t clockid, int flags, const struct timespec* req, struct timespec* rem)
+{
+    struct timespec now = { 0 };
+    long long nsec      = req->tv_sec * (long long)CLOCKNSEC + req->tv_nsec;
+
+    if (flags & TIMER_ABSTIME) {
+        sccroll_clockRead(clockid, &now);
+        nsec -= now.tv_sec * (long long)CLOCKNSEC + now.tv_nsec;
+    }
+    else if (rem) *rem = (struct timespec){ 0 };
+    if (nsec > 0) sccroll_mockAdvance(nsec);
+    return 0;
+}
+
+static int sccroll_clockPoll(struct pollfd* fds, nfds_t nfds, int timeout)
+{
+    int ready = libpoll(fds, nfds, 0);
+    if (!ready) sccroll_mockAdvance(timeout * 1000000ULL);
+    return ready;
+}
+
+static int sccroll_clockSelect(int nfds, fd_set* readfds, fd_set* writefds, fd_set* exceptfds, struct timeval* timeout)
+{
+    struct timeval none = { 0 };
+    int ready = libselect(nfds, readfds, writefds, exceptfds, &none);
+    // The remaining time is given back, as Linux does.
+    if (!ready) {
+        sccroll_mockAdvance(timeout->tv_sec * (unsigned long long)CLOCKNSEC + timeout->tv_usec * 1000ULL);
+        *timeout = none;
+    }
+    return ready;
+}
+
+SCCROLL_MOCK(sccroll_clockIs(CLOCK_REALTIME), sccroll_clockTime(tloc), time_t, time, time_t* tloc, tloc);
+
+SCCROLL_MOCK(
+    sccroll_clockIs(clockid),
+    sccroll_clockRead(clockid, tp), int, clock_gettime,
+    clockid_t clockid SCCCOMMA struct timespec* tp,
+    clockid, tp
+);
+
+SCCROLL_MOCK(
+    sccroll_clockIs(CLOCK_REALTIME),
+    sccroll_clockTimeofday(tv), int, gettimeofday,
+    struct timeval* restrict tv SCCCOMMA void* restrict tz,
+    tv, tz
+);
+
+SCCROLL_MOCK(
+    clocks.enabled,
+    (sccroll_mockAdvance(seconds * (unsigned long long)CLOCKNSEC), 0), unsigned int, sleep,
+    unsigned int seconds, seconds
+);
+
+SCCROLL_MOCK(
+    clocks.enabled,
+    (sccroll_mockAdvance(usec * 1000ULL), 0), int, usleep,
+    useconds_t usec, usec
+);
+
+SCCROLL_MOCK(
+    clocks.enabled,
+    sccroll_clockSleep(CLOCK_MONOTONIC, 0, req, rem), int, nanosleep,
+    const struct timespec* req SCCCOMMA struct timespec* rem,
+    req, rem
+);
+
+SCCROLL_MOCK(
+    sccroll_clockIs(clockid),
+    sccroll_clockSleep(clockid, flags, req, rem), int, clock_nanosleep,
+    clockid_t clockid SCCCOMMA int flags SCCCOMMA const struct timespec* req SCCCOMMA struct timespec* rem,
+    clockid, flags, req, rem
+);
+
+// The infinite timeouts are waited for real.
+SCCROLL_MOCK(
+    clocks.enabled && timeout > 0,
+    sccroll_clockPoll(fds, nfds, timeout), int, poll,
+    struct pollfd* fds SCCCOMMA nfds_t nfds SCCCOMMA int timeout,
+    fds, nfds, timeout
+);
+
+SCCROLL_MOCK(
+    clocks.enabled && timeout,
+    sccroll_clockSelect(nfds, readfds, writefds, exceptfds, timeout), int, select,
+    int nfds SCCCOMMA fd_set* readfds SCCCOMMA fd_set* writefds SCCCOMMA fd_set* exceptfds SCCCOMMA struct timeval* timeout,
+    nfds, readfds, writefds, exceptfds, timeout
+);
+
 // clang-format off
 
 /******************************************************************************
@@ -0,0 +1,31 @@
+/**
+ * @file        overhead.c
+ * @version     0.1.0
+ * @brief       Benchmark of the runner startup and per-test overhead.
+ * @author      Alexandre Martos
+ * @email       contact@amartos.fr
+ * @copyright   2023 Alexandre Martos <contact@amartos.fr>
+ * @license     MIT License
+ *
+ * @parblock
+ * The program runs the given number of empty tests, forked by
+ * default, or in the runner process if a second argument is given.
+ * Without arguments, no test is run, which gives the startup time.
+ * @endparblock
+ */
+
+#include "sccroll.h"
+
+// The test does nothing, only the runner work is measured.
+void test_empty(void) {}
+
+int main(int argc, char** argv)
+{
+    SccrollEffects test = {
+        .wrapper = test_empty,
+        .name = "test empty",
+        .flags = argc > 2 ? NOFORK : 0,
+    };
+    for (int i = argc > 1 ? atoi(argv[1]) : 0; i > 0; --i) sccroll_register(&test);
+    return sccroll_run();
+}
@@ -31,6 +31,9 @@ static const int testib[10] = {
 
 static const int testic[10] = { 0 };
 
+static const double testda[5] = { 0.5, 1.0, 1.5, 2.0, 2.5 };
+static const double testdb[5] = { 0.5, 1.001, 1.5, 2.0, 2.5 };
+
 // Compare two integers
 int intcmp(int a, int b) { return a == b ? 0 : a < b ? -1 : 1; };
 
@@ -46,7 +49,7 @@ int intcmp(int a, int b) { return a == b ? 0 : a < b ? -1 : 1; };
 
 // 1/2 tests should fail.
 enum {
-    FAILED = 12,
+    FAILED = 21,
 };
 
 SCCROLL_TEST(test_sccroll_assert_success) { sccroll_assert(true, "invisible line"); }
@@ -81,8 +84,106 @@ SCCROLL_TEST(test_assertSmallerOrEqual_success) {
     assertSmallerOrEqual(testia[0], testic[0], intcmp);
 }
 
+SCCROLL_TEST(
+    test_expect_fail,
+    .std = {
+        [STDOUT_FILENO] = {.content.blob = "continued"}
+    }
+)
+{
+    expect(false);
+    expectEql(a, c);
+    expectEqual(testia[0], testib[0], intcmp);
+    expectMsg(false, "row %i is wrong", 42);
+    printf("continued");
+}
+
+SCCROLL_TEST(test_assertArrayEqual_fail) { assertArrayEqual(testia, testic, 10); }
+SCCROLL_TEST(test_assertMemEqual_fail) { assertMemEqual("foo bar", "foo baz", 8); }
+SCCROLL_TEST(test_assertFloatsNear_fail) { assertFloatsNear(testda, testdb, 5, 1e-6); }
+
+// Only the first elements of a large array are dumped.
+SCCROLL_TEST(test_assertArrayEqual_large_fail)
+{
+    enum { SIZE = 100000 };
+    static unsigned short large[SIZE] = { 0 };
+    static unsigned short other[SIZE] = { 0 };
+    for (int i = SIZE / 2; i < SIZE; i += 1000) other[i] = i;
+    assertArrayEqual(large, other, SIZE);
+}
+
+SCCROLL_TEST(test_asserts_none, .flags = ASSERTS) {}
+
+SCCROLL_TEST(test_expect_nofork, .flags = NOFORK) { expectTrue(false); }
+
+// The failures of a forked test are not bounded by the pending
+// records size.
+SCCROLL_TEST(test_expect_many, .flags = NODIFF)
+{
+    for (int i = 0; i < 1000; ++i) expectNotEqual(testia[0], testib[9], intcmp);
+}
+
+// The soft assertions failures are reported along with the failed
+// assertion.
+SCCROLL_TEST(test_expect_assert_fail)
+{
+    expect(false);
+    assertMsg(false, "stopped at row %i", 42);
+}
+
 // After this point, no test should fail
 
+// The failed assertions are not printed on stderr.
+SCCROLL_TEST(test_assert_channel, .code = {.type = SCCSIGNAL, .value = SIGABRT}) { assert(false); }
+
+// The metrics do not change the test outcome.
+SCCROLL_TEST(test_metric)
+{
+    sccroll_metric("answer", 42);
+    sccroll_metric("ratio", 0.5);
+}
+
+SCCROLL_TEST(test_assert_arrays)
+{
+    static float nan[3] = { 0 };
+    nan[1] = 0.0f / 0.0f;
+    assertArrayEqual(testia, testia, 10);
+    assertArrayEqual(testia, testic, 1);
+    assertArrayEqual(testia, testib, 0);
+    assertMemEqual(testia, testia, sizeof(testia));
+    assertFloatsNear(testda, testdb, 5, 1e-2);
+    assertFloatsNear(testda, testdb, 1, 0);
+    // The bitwise comparison considers NaN equal to itself.
+    assertArrayEqual(nan, nan, 3);
+}
+
+// All the assertions are counted, soft ones included.
+SCCROLL_TEST(test_asserts_count, .flags = ASSERTS)
+{
+    unsigned long before = sccroll_asserts;
+    for (int i = 0; i < 1000; ++i) assert(i >= 0);
+    assertMsg(true, "counted");
+    sccroll_assert(true, "counted");
+    expect(true);
+    assertArrayEqual(testia, testia, 10);
+    assert(sccroll_asserts == before + 1005);
+}
+
+SCCROLL_TEST(test_expect_success)
+{
+    expect(true);
+    expectFalse(false);
+    expectNull(NULL);
+    expectEql(a, b);
+    expectNotEql(a, c);
+    expectEqual(testia, testia, memcmp, sizeof(testia));
+    expectNotEqual("foo", "bar", strcmp);
+    expectSmaller(testib[3], testia[2], intcmp);
+    expectGreater(testia[0], testib[0], intcmp);
+    expectSmallerOrEqual(testia[0], testic[0], intcmp);
+    expectGreaterOrEqual(testia[0], testib[9], intcmp);
+}
+
 SCCROLL_TEST(test_assert_array)
 {
     assertEqual(testia, testia, memcmp, sizeof(testia));
@@ -99,6 +99,12 @@ void test_dummy(void)
     }
 }
 
+// Print the expected string.
+void test_lazy(void)
+{
+    puts(contentstr);
+}
+
 // clang-format off
 
 /******************************************************************************
@@ -116,5 +122,15 @@ int main(void)
     sccroll_register(&test);
     assert(sccroll_run() == 2);
     cleantest();
+
+    // The standard IO files are only read once the test is run.
+    char path[BUFSIZ] = { 0 };
+    sprintf(path, template, "lazy", 0);
+    SccrollEffects lazy = { .wrapper = test_lazy, .name = "test lazy", .std[STDOUT_FILENO].path = path };
+    sccroll_register(&lazy);
+    int fd = openfile(path);
+    assert(fd >= 0 && write(fd, contentstr, strlen(contentstr)*sizeof(char)) >= 0 && !close(fd));
+    assert(!sccroll_run());
+    assert(!remove(path));
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,123 @@
+/**
+ * @file        hashes.c
+ * @version     0.1.0
+ * @brief       Core module unit tests for hashed files handling.
+ * @author      Alexandre Martos
+ * @email       contact@amartos.fr
+ * @copyright   2022-2023 Alexandre Martos <contact@amartos.fr>
+ * @license     MIT License
+ */
+
+#include <assert.h>
+
+#include "sccroll.h"
+
+// clang-format off
+
+/******************************************************************************
+ * Preparation
+ ******************************************************************************/
+// clang-format on
+
+// Constants
+enum {
+    SIZE = 1 << 20, // Written file size, far above SCCMAX.
+    MOD  = 251,     // Written bytes pattern modulo.
+};
+
+// Files paths.
+#define output "/tmp/sccroll.hashes.output"
+#define reference "/tmp/sccroll.hashes.reference"
+
+// Digest of the SIZE first bytes of the sequence 0, 1, ..., 250, 0,
+// 1, ...
+#define outputhash "74cb441fd087764ca9c3694da742ebe30cbeb3060a17009ca81825c7a8d10343"
+
+#define contentstr "expected string"
+#define errstr "this is not expected"
+
+// Write the pattern in the output file.
+void test_pattern(void)
+{
+    FILE* stream = fopen(output, "w");
+    if (!stream) err(EXIT_FAILURE, "could not open %s", output);
+    for (int i = 0; i < SIZE; ++i) fputc(i % MOD, stream);
+    fclose(stream);
+}
+
+// Write a string in the output file.
+void test_string(void)
+{
+    FILE* stream = fopen(output, "w");
+    if (!stream || fputs(errstr, stream) < 0)
+        err(EXIT_FAILURE, "could not write in %s", output);
+    fclose(stream);
+}
+
+// clang-format off
+
+/******************************************************************************
+ * Execution
+ ******************************************************************************/
+// clang-format on
+
+int main(void)
+{
+    char hex[SCCHASHHEX] = { 0 };
+    char upper[SCCHASHHEX] = outputhash;
+    SccrollEffects test = {
+        .wrapper = test_pattern,
+        .name = "test hash",
+        .files[0] = { .path = output, .hash = outputhash, .content.size = SIZE },
+    };
+    sccroll_register(&test);
+
+    // Digests are case insensitive, and the size is optional.
+    test.name = "test hash no size";
+    for (char* c = upper; *c; ++c) *c = toupper(*c);
+    test.files[0] = (SccrollFile){ .path = output, .hash = upper };
+    sccroll_register(&test);
+    assert(!sccroll_run());
+
+    test.name = "test hash size mismatch";
+    test.files[0] = (SccrollFile){ .path = output, .hash = outputhash, .content.size = SIZE - 1 };
+    sccroll_register(&test);
+    assert(sccroll_run() == 1);
+
+    // Without reference, the digests are reported.
+    test.wrapper = test_string;
+    test.name = "test hash mismatch";
+    test.files[0] = (SccrollFile){ .path = output, .hash = sccroll_hash(contentstr, strlen(contentstr), hex) };
+    sccroll_register(&test);
+    assert(sccroll_run() == 1);
+
+    // With a reference, the contents are diffed.
+    FILE* stream = fopen(reference, "w");
+    assert(stream && fputs(contentstr, stream) >= 0);
+    fclose(stream);
+    test.name = "test hash reference";
+    test.files[0].ref = reference;
+    sccroll_register(&test);
+    test.name = "test hash reference nodiff";
+    test.flags = NODIFF;
+    sccroll_register(&test);
+    assert(sccroll_run() == 2);
+
+    // Only the bytes around the first difference with a large
+    // reference are dumped.
+    stream = fopen(reference, "w+");
+    assert(stream);
+    for (int i = 0; i < SIZE; ++i) fputc(i == SIZE / 2 ? MOD : i % MOD, stream);
+    rewind(stream);
+    assert(sccroll_hashFile(stream, hex) == SIZE);
+    fclose(stream);
+    test.wrapper = test_pattern;
+    test.name = "test hash reference large";
+    test.flags = 0;
+    test.files[0] = (SccrollFile){ .path = output, .hash = hex, .ref = reference };
+    sccroll_register(&test);
+    assert(sccroll_run() == 1);
+
+    assert(!remove(output) && !remove(reference));
+    return EXIT_SUCCESS;
+}
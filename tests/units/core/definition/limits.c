@@ -0,0 +1,161 @@
+/**
+ * @file        limits.c
+ * @version     0.1.0
+ * @brief       Core module unit tests for the tests resources limits.
+ * @author      Alexandre Martos
+ * @email       contact@amartos.fr
+ * @copyright   2022-2023 Alexandre Martos <contact@amartos.fr>
+ * @license     MIT License
+ */
+
+#include <assert.h>
+
+#include "sccroll.h"
+
+// clang-format off
+
+/******************************************************************************
+ * Preparation
+ ******************************************************************************/
+// clang-format on
+
+// Constants
+enum {
+    MEMORY = 1 << 26, // Memory limit, in bytes.
+    OUTPUT = 1 << 10, // Written files size limit, in bytes.
+    FILES  = 16,      // File descriptors limit.
+};
+
+// Written file.
+#define written "/tmp/sccroll.limits.output"
+
+// Never ends.
+void test_spin(void) { for (volatile int i = 0;; ++i); }
+
+// Never ends, even when warned of its CPU time limit.
+void test_ignore(void)
+{
+    signal(SIGXCPU, SIG_IGN);
+    test_spin();
+}
+
+// Write more than the output limit.
+void test_write(void)
+{
+    char buffer[OUTPUT * 2] = { 0 };
+    FILE* stream = fopen(written, "w");
+    assert(stream);
+    fwrite(buffer, sizeof(char), sizeof(buffer), stream);
+    fclose(stream);
+}
+
+// The allocations above the memory limit fail.
+void test_memory(void) { assert(!malloc(MEMORY * 4)); }
+
+// The cgroups hosting the memory limited tests are usable: the
+// runner cgroup is writable, the memory controller is available to
+// it, and it holds only the runner unless it is the root cgroup.
+bool usable = false;
+
+// Give the cgroup v2 path of the calling process.
+void cgroup(char path[PATH_MAX])
+{
+    char line[PATH_MAX] = { 0 };
+    FILE* stream = fopen("/proc/self/cgroup", "r");
+    assert(stream);
+    while (fgets(line, PATH_MAX, stream) && strncmp(line, "0::", 3));
+    fclose(stream);
+    line[strcspn(line, "\n")] = 0;
+    *path = 0;
+    if (!strncmp(line, "0::", 3)) snprintf(path, PATH_MAX, SCCCGROUP "%s", line + 3);
+}
+
+// Read the first line of a cgroup interface file, or an empty string.
+void readcg(const char* leaf, const char* name, char line[SCCMAX])
+{
+    char path[PATH_MAX] = { 0 };
+    FILE* stream = NULL;
+    *line = 0;
+    snprintf(path, PATH_MAX, "%s/%s", leaf, name);
+    if (!(stream = fopen(path, "r"))) return;
+    if (!fgets(line, SCCMAX, stream)) *line = 0;
+    fclose(stream);
+}
+
+// Tell if the runner cgroup can host the tests ones.
+bool cgroups(void)
+{
+    char path[PATH_MAX] = { 0 };
+    char line[SCCMAX] = { 0 };
+    FILE* stream = NULL;
+    int procs = 0;
+
+    cgroup(path);
+    readcg(path, "cgroup.controllers", line);
+    if (!*path || !strstr(line, "memory") || access(path, W_OK)) return false;
+    if (!strcmp(path, SCCCGROUP "/")) return true;
+
+    snprintf(line, SCCMAX, "%s/cgroup.procs", path);
+    if (!(stream = fopen(line, "r"))) return false;
+    while (fgets(line, SCCMAX, stream)) ++procs;
+    fclose(stream);
+    return procs == 1;
+}
+
+// The memory limited test runs in its own cgroup when possible.
+void test_cgroup(void)
+{
+    char path[PATH_MAX] = { 0 };
+    char line[SCCMAX] = { 0 };
+
+    cgroup(path);
+    assert(usable == (strstr(path, "/sccroll.") != NULL));
+    if (!usable) return;
+    readcg(path, "memory.max", line);
+    assert(strtoull(line, NULL, 10) == MEMORY);
+}
+
+// The files opened above the files limit fail.
+void test_files(void)
+{
+    int count = 0;
+    while (open("/dev/null", O_RDONLY) >= 0) assert(++count < FILES);
+    assert(errno == EMFILE);
+}
+
+// clang-format off
+
+/******************************************************************************
+ * Execution
+ ******************************************************************************/
+// clang-format on
+
+int main(void)
+{
+    // Checked before the runner moves to its own cgroup.
+    usable = cgroups();
+
+    SccrollEffects test = { .wrapper = test_spin, .name = "test cpu", .limits.cpu = 1 };
+    sccroll_register(&test);
+    // Killed at the hard limit.
+    test = (SccrollEffects){ .wrapper = test_ignore, .name = "test cpu ignored", .limits.cpu = 1 };
+    sccroll_register(&test);
+    test = (SccrollEffects){ .wrapper = test_write, .name = "test output", .limits.output = OUTPUT };
+    sccroll_register(&test);
+    assert(sccroll_run() == 3);
+
+    // Expected signals are not reported as limits breaches.
+    test.name = "test output expected";
+    test.code = (SccrollCode){ .type = SCCSIGNAL, .value = SIGXFSZ };
+    sccroll_register(&test);
+    test = (SccrollEffects){ .wrapper = test_memory, .name = "test memory", .limits.memory = MEMORY };
+    sccroll_register(&test);
+    test = (SccrollEffects){ .wrapper = test_files, .name = "test files", .limits.files = FILES };
+    sccroll_register(&test);
+    test = (SccrollEffects){ .wrapper = test_cgroup, .name = "test cgroup", .limits.memory = MEMORY };
+    sccroll_register(&test);
+    assert(!sccroll_run());
+
+    assert(!remove(written));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file        trees.c
+ * @version     0.1.0
+ * @brief       Core module unit tests for files trees handling.
+ * @author      Alexandre Martos
+ * @email       contact@amartos.fr
+ * @copyright   2022-2023 Alexandre Martos <contact@amartos.fr>
+ * @license     MIT License
+ */
+
+#include "units.h"
+
+// clang-format off
+
+/******************************************************************************
+ * Preparation
+ ******************************************************************************/
+// clang-format on
+
+// Constants
+enum {
+    FILES = 10,  // Number of files of each subdirectory.
+    DIRS  = 3,   // Number of subdirectories.
+};
+
+// Trees roots.
+#define expected "/tmp/sccroll.trees.expected"
+#define output "/tmp/sccroll.trees.output"
+
+// Write a file of a tree.
+void mkfile(const char* restrict root, const char* restrict name, const char* restrict content)
+{
+    char path[PATH_MAX] = { 0 };
+    sprintf(path, "%s/%s", root, name);
+    FILE* stream = fopen(path, "w");
+    if (!stream || fputs(content, stream) < 0)
+        err(EXIT_FAILURE, "could not write in %s", path);
+    fclose(stream);
+}
+
+// Write a tree of DIRS subdirectories of FILES files each.
+void mktree(const char* restrict root)
+{
+    char name[PATH_MAX] = { 0 };
+    if (mkdir(root, 0755) && errno != EEXIST)
+        err(EXIT_FAILURE, "could not create %s", root);
+    for (int i = 0; i < DIRS; ++i) {
+        sprintf(name, "%s/%i", root, i);
+        if (mkdir(name, 0755) && errno != EEXIST)
+            err(EXIT_FAILURE, "could not create %s", name);
+        for (int j = 0; j < FILES; ++j) {
+            sprintf(name, "%i/%i", i, j);
+            mkfile(root, name, name);
+        }
+    }
+}
+
+// Write the same tree as the expected one.
+void test_same(void)
+{
+    mktree(output);
+}
+
+// Write a tree with a missing, an extra and two different files.
+void test_different(void)
+{
+    char path[PATH_MAX] = { 0 };
+    mktree(output);
+    sprintf(path, "%s/0/4", output);
+    assert(!remove(path));
+    mkfile(output, "extra", "extra");
+    mkfile(output, "1/5", "1/50");
+    mkfile(output, "2/9", "2/8");
+}
+
+// Write nothing.
+void test_nothing(void) {}
+
+// clang-format off
+
+/******************************************************************************
+ * Execution
+ ******************************************************************************/
+// clang-format on
+
+int main(void)
+{
+    mktree(expected);
+    SccrollEffects test = {
+        .wrapper = test_same,
+        .name = "test tree",
+        .files[0] = { .path = output, .tree = expected },
+    };
+    sccroll_register(&test);
+    assert(!sccroll_run());
+
+    test.wrapper = test_different;
+    test.name = "test tree different";
+    sccroll_register(&test);
+    test.name = "test tree different nodiff";
+    test.flags = NODIFF;
+    sccroll_register(&test);
+    assert(sccroll_run() == 2);
+
+    // A missing tree is empty.
+    rmtree(output);
+    test.wrapper = test_nothing;
+    test.name = "test tree missing";
+    test.files[0] = (SccrollFile){ .path = output "/0", .tree = expected "/0" };
+    test.flags = 0;
+    sccroll_register(&test);
+    assert(sccroll_run() == 1);
+
+    rmtree(output);
+    rmtree(expected);
+    return EXIT_SUCCESS;
+}
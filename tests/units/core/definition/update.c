@@ -0,0 +1,131 @@
+/**
+ * @file        update.c
+ * @version     0.1.0
+ * @brief       Core module unit tests for the expectations update.
+ * @author      Alexandre Martos
+ * @email       contact@amartos.fr
+ * @copyright   2022-2023 Alexandre Martos <contact@amartos.fr>
+ * @license     MIT License
+ */
+
+#include "units.h"
+
+// clang-format off
+
+/******************************************************************************
+ * Preparation
+ ******************************************************************************/
+// clang-format on
+
+// Files paths.
+#define stdoutfile "/tmp/sccroll.update.stdout"
+#define expected "/tmp/sccroll.update.expected"
+#define output "/tmp/sccroll.update.output"
+#define hashed "/tmp/sccroll.update.hashed"
+#define reference "/tmp/sccroll.update.reference"
+
+#define oldstr "old output"
+#define newstr "new output"
+
+// Write a file.
+void mkfile(const char* restrict path, const char* restrict content)
+{
+    FILE* stream = fopen(path, "w");
+    if (!stream || fputs(content, stream) < 0)
+        err(EXIT_FAILURE, "could not write in %s", path);
+    fclose(stream);
+}
+
+// Print the new output, write a hashed file, and a tree with a new
+// file, a modified one, and without the expected "removed" one.
+void test_new(void)
+{
+    printf(newstr);
+    mkfile(hashed, newstr);
+    assert(!mkdir(output, 0755) && !mkdir(output "/dir", 0755));
+    mkfile(output "/same", oldstr);
+    mkfile(output "/modified", newstr);
+    mkfile(output "/dir/new", newstr);
+}
+
+// Fill the standard output capture buffer.
+void test_full(void)
+{
+    for (int i = 0; i < SCCMAX; ++i) putchar('x');
+}
+
+// clang-format off
+
+/******************************************************************************
+ * Execution
+ ******************************************************************************/
+// clang-format on
+
+int main(void)
+{
+    char hex[SCCHASHHEX] = { 0 };
+    assert(!mkdir(expected, 0755));
+    mkfile(stdoutfile, oldstr);
+    mkfile(reference, oldstr);
+    mkfile(expected "/same", oldstr);
+    mkfile(expected "/modified", oldstr);
+    mkfile(expected "/removed", oldstr);
+    SccrollEffects test = {
+        .wrapper = test_new,
+        .name = "test update",
+        .std[STDOUT_FILENO].path = stdoutfile,
+        .files[0] = { .path = output, .tree = expected },
+        .files[1] = { .path = hashed, .hash = sccroll_hash(oldstr, strlen(oldstr), hex), .ref = reference },
+    };
+
+    // Only non-empty values other than 0 enable the update.
+    assert(!setenv(SCCUPDATE, "0", 1));
+    test.name = "test update disabled";
+    sccroll_register(&test);
+    assert(sccroll_run() == 1);
+    rmtree(output);
+
+    assert(!setenv(SCCUPDATE, "1", 1));
+    test.name = "test update";
+    sccroll_register(&test);
+    assert(!sccroll_run());
+    rmtree(output);
+    checkfile(stdoutfile, newstr "\n");
+    checkfile(reference, newstr);
+    checkfile(expected "/same", oldstr);
+    checkfile(expected "/modified", newstr);
+    checkfile(expected "/dir/new", newstr);
+    assert(access(expected "/removed", F_OK));
+
+    // The updated expectations now pass, once the inline digest is
+    // replaced by the reported one.
+    assert(!unsetenv(SCCUPDATE));
+    sccroll_hash(newstr, strlen(newstr), hex);
+    test.name = "test update updated";
+    sccroll_register(&test);
+    assert(!sccroll_run());
+    rmtree(output);
+
+    // The expectations not stored on disk are still compared.
+    assert(!setenv(SCCUPDATE, "1", 1));
+    test.name = "test update inline";
+    test.std[STDOUT_FILENO] = (SccrollFile){ .content.blob = oldstr };
+    sccroll_register(&test);
+    assert(sccroll_run() == 1);
+
+    // A full capture may be truncated, and is not written.
+    SccrollEffects full = {
+        .wrapper = test_full,
+        .name = "test update truncated",
+        .flags = NODIFF,
+        .std[STDOUT_FILENO].path = stdoutfile,
+    };
+    sccroll_register(&full);
+    assert(sccroll_run() == 1);
+    checkfile(stdoutfile, newstr "\n");
+
+    rmtree(output);
+    rmtree(expected);
+    assert(!remove(stdoutfile) && !remove(hashed) && !remove(reference));
+    return EXIT_SUCCESS;
+}
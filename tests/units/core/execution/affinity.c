@@ -0,0 +1,83 @@
+/**
+ * @file        affinity.c
+ * @version     0.1.0
+ * @brief       Core module unit tests for the suites workers placement.
+ * @author      Alexandre Martos
+ * @email       contact@amartos.fr
+ * @copyright   2022-2023 Alexandre Martos <contact@amartos.fr>
+ * @license     MIT License
+ */
+
+#include "units.h"
+
+// clang-format off
+
+/******************************************************************************
+ * Preparation
+ ******************************************************************************/
+// clang-format on
+
+// Constants
+enum {
+    TESTS = 4, // Number of tests of each suite.
+};
+
+// Workers reports file.
+#define reports "/tmp/sccroll.affinity.reports"
+
+SCCROLL_SUITE(suite_pinned, .jobs = 2, .cpus = "0") {}
+SCCROLL_SUITE(suite_all, .jobs = -1, .cpus = "", .numa = true) {}
+
+// The workers are pinned to a single CPU.
+void test_pinned(void)
+{
+    cpu_set_t set = { 0 };
+    assert(!sched_getaffinity(0, sizeof(set), &set));
+    assert(CPU_COUNT(&set) == 1);
+}
+
+// Run the given suite with an invalid CPUs list.
+void run_invalid(const char* restrict cpus)
+{
+    pid_t pid = fork();
+    int status = 0;
+    assert(pid >= 0);
+    if (!pid) {
+        assert(freopen("/dev/null", "w", stderr));
+        sccroll_suite(&(SccrollSuite){ .name = "invalid", .jobs = 2, .cpus = cpus });
+        for (int i = 0; i < TESTS; ++i)
+            sccroll_register(&(SccrollEffects){ .wrapper = test_pinned, .name = "test invalid", .suite = "invalid" });
+        exit(sccroll_run());
+    }
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_FAILURE);
+}
+
+// clang-format off
+
+/******************************************************************************
+ * Execution
+ ******************************************************************************/
+// clang-format on
+
+int main(void)
+{
+    SccrollEffects pinned = { .wrapper = test_pinned, .name = "test pinned", .suite = "suite_pinned" };
+    SccrollEffects all = { .wrapper = test_pinned, .name = "test all", .suite = "suite_all" };
+    for (int i = 0; i < TESTS; ++i) sccroll_register(&pinned);
+    for (int i = 0; i < TESTS; ++i) sccroll_register(&all);
+    assert(!sccroll_run());
+
+    // The workers report their utilization on demand.
+    assert(!setenv(SCCWORKERS, "1", 1));
+    for (int i = 0; i < TESTS; ++i) sccroll_register(&pinned);
+    runto(reports, 0);
+    assert(!unsetenv(SCCWORKERS));
+    checkfind(reports, "suite_pinned: worker 1 on CPU 0: ", true);
+    assert(!remove(reports));
+
+    run_invalid("x");
+    run_invalid("3-1");
+    run_invalid("0-");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file        crash.c
+ * @version     0.1.0
+ * @brief       Core module unit tests for the crashes reports.
+ * @author      Alexandre Martos
+ * @email       contact@amartos.fr
+ * @copyright   2022-2023 Alexandre Martos <contact@amartos.fr>
+ * @license     MIT License
+ */
+
+#include "units.h"
+
+// clang-format off
+
+/******************************************************************************
+ * Preparation
+ ******************************************************************************/
+// clang-format on
+
+// Crashes reports file.
+#define reports "/tmp/sccroll.crash.reports"
+
+// The tests of this suite are run by workers.
+SCCROLL_SUITE(suite_parallel, .jobs = 2) {}
+
+// Dereference an invalid pointer.
+void test_segv(void)
+{
+    volatile int* pointer = (int*)sizeof(int);
+    *pointer = 0;
+}
+
+// Overflow the stack; the depth never gets negative.
+int overflow(int depth)
+{
+    volatile char frame[BUFSIZ] = { 0 };
+    if (depth < 0) return 0;
+    frame[0] = depth;
+    return overflow(depth + 1) + frame[0];
+}
+
+void test_overflow(void) { overflow(0); }
+
+// clang-format off
+
+/******************************************************************************
+ * Execution
+ ******************************************************************************/
+// clang-format on
+
+int main(void)
+{
+    // The crashes are reported with their address and backtrace,
+    // even on a stack overflow.
+    sccroll_register(&(SccrollEffects){ .wrapper = test_segv, .name = "test segv", .suite = "suite_parallel" });
+    sccroll_register(&(SccrollEffects){ .wrapper = test_overflow, .name = "test overflow" });
+    runto(reports, 2);
+    checkfind(reports, "test segv: SIGSEGV (code 1) at 0x4\n#0 sccroll_channelCrash (", true);
+    checkfind(reports, "test overflow: SIGSEGV (code ", true);
+    checkfind(reports, "#1 ", true);
+    checkfind(reports, "stderr", false);
+
+    // The expected crashes are not reported.
+    sccroll_register(&(SccrollEffects){
+        .wrapper = test_segv,
+        .name = "test expected segv",
+        .code = { .type = SCCSIGNAL, .value = SIGSEGV },
+    });
+    runto(reports, 0);
+    checkfind(reports, "SGNL", false);
+    assert(!remove(reports));
+    return EXIT_SUCCESS;
+}
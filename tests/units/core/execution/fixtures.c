@@ -0,0 +1,105 @@
+/**
+ * @file        fixtures.c
+ * @version     0.1.0
+ * @brief       Core module unit tests for the fixtures.
+ * @author      Alexandre Martos
+ * @email       contact@amartos.fr
+ * @copyright   2022-2023 Alexandre Martos <contact@amartos.fr>
+ * @license     MIT License
+ */
+
+#include "units.h"
+
+// clang-format off
+
+/******************************************************************************
+ * Preparation
+ ******************************************************************************/
+// clang-format on
+
+// Constants
+enum {
+    SIZE  = 1024, // Number of values of the dataset.
+    TESTS = 5,    // Number of tests using the dataset.
+};
+
+// File logging the fixtures calls.
+#define calls "/tmp/sccroll.fixtures.calls"
+
+// The shared state, and the processes ids.
+static int* dataset = NULL;
+static pid_t runner = 0;
+static pid_t owner  = 0;
+
+// Log a fixture call.
+void mark(const char* restrict call)
+{
+    FILE* stream = fopen(calls, "a");
+    if (!stream || fputs(call, stream) < 0)
+        err(EXIT_FAILURE, "could not write in %s", calls);
+    fclose(stream);
+}
+
+void teardown(void)
+{
+    mark("teardown\n");
+    free(dataset);
+    dataset = NULL;
+}
+
+// Build the dataset once, outside of the tests runner.
+SCCROLL_FIXTURE(fixture_dataset, .teardown = teardown)
+{
+    mark("setup\n");
+    assert((owner = getpid()) != runner);
+    assert((dataset = malloc(SIZE * sizeof(int))));
+    for (int i = 0; i < SIZE; ++i) dataset[i] = i;
+}
+
+// Crash before running any test.
+void fixture_broken(void) { abort(); }
+
+// Check that the dataset is pristine, and the test forked from the
+// fixture process, then alter the dataset.
+void test_dataset(void)
+{
+    assert(dataset && getppid() == owner);
+    for (int i = 0; i < SIZE; ++i) assert(dataset[i] == i);
+    memset(dataset, 0, SIZE * sizeof(int));
+}
+
+// The tests without fixture are not affected.
+void test_none(void) { assert(!dataset); }
+
+// clang-format off
+
+/******************************************************************************
+ * Execution
+ ******************************************************************************/
+// clang-format on
+
+int main(void)
+{
+    runner = getpid();
+    sccroll_fixture(&(SccrollFixture){ .name = "broken", .setup = fixture_broken });
+
+    SccrollEffects test = { .wrapper = test_dataset, .name = "test dataset", .fixture = "fixture_dataset" };
+    for (int i = 0; i < TESTS; ++i) sccroll_register(&test);
+    // The other tests are interleaved with the ones of the fixture.
+    sccroll_register(&(SccrollEffects){ .wrapper = test_none, .name = "test none" });
+    sccroll_register(&test);
+    assert(!sccroll_run());
+
+    // The fixture is built and released once, in its own process.
+    checkfile(calls, "setup\nteardown\n");
+    assert(!dataset && !owner);
+    assert(!remove(calls));
+
+    // All the tests of a failing fixture fail.
+    test = (SccrollEffects){ .wrapper = test_dataset, .name = "test broken", .fixture = "broken" };
+    sccroll_register(&test);
+    sccroll_register(&test);
+    sccroll_register(&(SccrollEffects){ .wrapper = test_none, .name = "test none" });
+    assert(sccroll_run() == 2);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file        profile.c
+ * @version     0.1.0
+ * @brief       Core module unit tests for the runner self-profiling.
+ * @author      Alexandre Martos
+ * @email       contact@amartos.fr
+ * @copyright   2022-2023 Alexandre Martos <contact@amartos.fr>
+ * @license     MIT License
+ */
+
+#include "units.h"
+
+// clang-format off
+
+/******************************************************************************
+ * Preparation
+ ******************************************************************************/
+// clang-format on
+
+// Profiling reports file, and compared file.
+#define reports "/tmp/sccroll.profile.reports"
+#define compared "/tmp/sccroll.profile.compared"
+
+// The tests of this suite are run by workers.
+SCCROLL_SUITE(suite_parallel, .jobs = 2) {}
+
+void test_print(void) { printf("foo"); }
+
+// clang-format off
+
+/******************************************************************************
+ * Execution
+ ******************************************************************************/
+// clang-format on
+
+int main(void)
+{
+    SccrollEffects test = {
+        .wrapper = test_print,
+        .name = "test profile",
+        .std[STDOUT_FILENO].content.blob = "foo",
+        .files[0] = { .path = compared, .content.blob = "bar" },
+        .flags = NODIFF,
+    };
+    SccrollEffects nofork = test;
+    nofork.flags |= NOFORK;
+
+    FILE* stream = fopen(compared, "w");
+    assert(stream && fputs("bar", stream) >= 0 && !fclose(stream));
+
+    // The timings of all the processes are aggregated.
+    assert(!setenv(SCCPROFILE, "1", 1));
+    sccroll_register(&nofork);
+    test.suite = "suite_parallel";
+    sccroll_register(&test);
+    sccroll_register(&test);
+    test.suite = NULL;
+    sccroll_register(&test);
+    runto(reports, 0);
+    checkfind(reports, "load: 4 calls", true);
+    checkfind(reports, "pipes: 4 calls", true);
+    checkfind(reports, "fork: 3 calls", true);
+    checkfind(reports, "stdin: 4 calls", true);
+    checkfind(reports, "test: 4 calls", true);
+    checkfind(reports, "wait: 3 calls", true);
+    checkfind(reports, "capture: 4 calls", true);
+    checkfind(reports, "files: 4 calls", true);
+    checkfind(reports, "diff: 4 calls", true);
+
+    // Disabled by default.
+    assert(!unsetenv(SCCPROFILE));
+    sccroll_register(&test);
+    runto(reports, 0);
+    checkfind(reports, "PROF", false);
+    assert(!remove(reports) && !remove(compared));
+    return EXIT_SUCCESS;
+}
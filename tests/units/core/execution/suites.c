@@ -0,0 +1,133 @@
+/**
+ * @file        suites.c
+ * @version     0.1.0
+ * @brief       Core module unit tests for the suites.
+ * @author      Alexandre Martos
+ * @email       contact@amartos.fr
+ * @copyright   2022-2023 Alexandre Martos <contact@amartos.fr>
+ * @license     MIT License
+ */
+
+#include <assert.h>
+
+#include "sccroll.h"
+
+#include <fcntl.h>
+#include <time.h>
+
+// clang-format off
+
+/******************************************************************************
+ * Preparation
+ ******************************************************************************/
+// clang-format on
+
+// Constants
+enum {
+    JOBS  = 4,      // Number of concurrent tests of the parallel suite.
+    SLEEP = 250000, // Duration of the parallel tests, in microseconds.
+};
+
+// Lock file of the serial suite.
+#define lock "/tmp/sccroll.suites.lock"
+
+// The suites hooks calls counts, and the tests runner process id.
+static int inits    = 0;
+static int cleans   = 0;
+static pid_t runner = 0;
+
+void clean(void)
+{
+    assert(getpid() == runner);
+    ++cleans;
+}
+
+SCCROLL_SUITE(suite_parallel, .jobs = JOBS, .clean = clean)
+{
+    assert(getpid() == runner);
+    ++inits;
+}
+
+SCCROLL_SUITE(suite_serial, .jobs = 0) {}
+
+// Used by the parallel suite.
+void test_sleep(void) { usleep(SLEEP); }
+
+// The serial suite tests hold a lock for their whole duration.
+void test_lock(void)
+{
+    int fd = open(lock, O_CREAT | O_EXCL | O_WRONLY, 0644);
+    assert(fd >= 0);
+    usleep(SLEEP / 10);
+    close(fd);
+    assert(!remove(lock));
+}
+
+// Fails.
+void test_fail(void) { assert(false); }
+
+// Give the current time in microseconds.
+long long now(void)
+{
+    struct timespec time = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000000LL + time.tv_nsec / 1000;
+}
+
+// clang-format off
+
+/******************************************************************************
+ * Execution
+ ******************************************************************************/
+// clang-format on
+
+int main(void)
+{
+    runner = getpid();
+    SccrollEffects parallel = { .wrapper = test_sleep, .name = "test parallel", .suite = "suite_parallel" };
+    SccrollEffects serial = { .wrapper = test_lock, .name = "test serial", .suite = "suite_serial" };
+    SccrollEffects unknown = { .wrapper = test_lock, .name = "test unknown suite", .suite = "unknown" };
+    SccrollEffects none = { .wrapper = test_lock, .name = "test no suite" };
+
+    // The parallel tests are run at the same time, but the hooks are
+    // called once.
+    for (int i = 0; i < JOBS; ++i) sccroll_register(&parallel);
+    for (int i = 0; i < JOBS; ++i) sccroll_register(&serial);
+    sccroll_register(&unknown);
+    sccroll_register(&none);
+    long long start = now();
+    assert(!sccroll_run());
+    assert(now() - start < JOBS * SLEEP);
+    assert(inits == 1 && cleans == 1);
+
+    // The failures of the workers are reported.
+    parallel.name = "test parallel fail";
+    parallel.wrapper = test_fail;
+    parallel.flags = NODIFF;
+    sccroll_register(&parallel);
+    parallel.name = "test parallel";
+    parallel.wrapper = test_sleep;
+    parallel.flags = 0;
+    sccroll_register(&parallel);
+    sccroll_register(&parallel);
+    assert(sccroll_run() == 1);
+
+    // Only the selected suites are run.
+    assert(!setenv(SCCSUITES, "unknown,suite_serial", 1));
+    parallel.wrapper = test_fail;
+    sccroll_register(&parallel);
+    sccroll_register(&serial);
+    sccroll_register(&unknown);
+    sccroll_register(&none);
+    none.wrapper = test_fail;
+    sccroll_register(&none);
+    assert(!sccroll_run());
+    assert(inits == 2 && cleans == 2);
+
+    // Nothing selected.
+    assert(!setenv(SCCSUITES, "suite", 1));
+    sccroll_register(&serial);
+    assert(!sccroll_run());
+    assert(!unsetenv(SCCSUITES));
+    return EXIT_SUCCESS;
+}
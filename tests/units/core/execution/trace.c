@@ -0,0 +1,98 @@
+/**
+ * @file        trace.c
+ * @version     0.1.0
+ * @brief       Core module unit tests for the run trace.
+ * @author      Alexandre Martos
+ * @email       contact@amartos.fr
+ * @copyright   2022-2023 Alexandre Martos <contact@amartos.fr>
+ * @license     MIT License
+ */
+
+#include <assert.h>
+
+#include "sccroll.h"
+
+// clang-format off
+
+/******************************************************************************
+ * Preparation
+ ******************************************************************************/
+// clang-format on
+
+// Constants
+enum {
+    TESTS  = 4,     // Number of tests of the parallel suite.
+    BUFFER = 65536, // Size of the trace buffer.
+};
+
+// Trace file.
+#define tracefile "/tmp/sccroll.trace.json"
+
+// The tests of this suite are run by workers.
+SCCROLL_SUITE(suite_parallel, .jobs = 2) {}
+
+void test_pass(void) {}
+
+// Fails.
+void test_fail(void) { assert(false); }
+
+// Count the occurrences of a string in another.
+int count(const char* restrict string, const char* restrict pattern)
+{
+    int found = 0;
+    for (const char* next = string; (next = strstr(next, pattern)); ++next) ++found;
+    return found;
+}
+
+// clang-format off
+
+/******************************************************************************
+ * Execution
+ ******************************************************************************/
+// clang-format on
+
+int main(void)
+{
+    static char buffer[BUFFER] = { 0 };
+    SccrollEffects test = { .wrapper = test_pass, .name = "test pass", .suite = "suite_parallel" };
+    for (int i = 0; i < TESTS; ++i) sccroll_register(&test);
+    sccroll_register(&(SccrollEffects){ .wrapper = test_fail, .name = "test \"fail\"", .flags = NODIFF });
+    sccroll_register(&(SccrollEffects){ .wrapper = test_pass, .name = "test nofork", .flags = NOFORK });
+
+    assert(!setenv(SCCTRACE, tracefile, 1));
+    assert(sccroll_run() == 1);
+    assert(!unsetenv(SCCTRACE));
+
+    FILE* stream = fopen(tracefile, "r");
+    assert(stream && fread(buffer, sizeof(char), BUFFER - 1, stream) > 0);
+    fclose(stream);
+
+    // The events form a JSON array.
+    assert(!strncmp(buffer, "[\n", 2));
+    assert(!strcmp(buffer + strlen(buffer) - 5, "}}\n]\n"));
+
+    // Each worker has its own lane.
+    assert(count(buffer, "\"name\":\"runner\"") == 1);
+    assert(count(buffer, "\"name\":\"suite_parallel worker 0 (CPU any)\"") == 1);
+    assert(count(buffer, "\"name\":\"suite_parallel worker 1 (CPU any)\"") == 1);
+
+    // Each test is a span, with its phases.
+    assert(count(buffer, "\"cat\":\"test\"") == TESTS + 2);
+    // The failed test process was stopped before the end of its test
+    // phase.
+    assert(count(buffer, "\"name\":\"test\",\"cat\":\"phase\"") == TESTS + 1);
+    assert(count(buffer, "\"name\":\"fork\",\"cat\":\"phase\"") == TESTS + 1);
+    assert(count(buffer, "\"name\":\"test pass\",\"cat\":\"test\"") == TESTS);
+    assert(count(buffer, "\"name\":\"test \\\"fail\\\"\",\"cat\":\"test\"") == 1);
+    assert(count(buffer, "\"status\":\"pass\"") == TESTS + 1);
+    assert(count(buffer, "\"status\":\"fail\"") == 1);
+    assert(count(buffer, "\"asserts\":0,") == TESTS + 2);
+    assert(count(buffer, "\"tid\":1,") && count(buffer, "\"tid\":2,"));
+    assert(!remove(tracefile));
+
+    // Disabled by default.
+    sccroll_register(&test);
+    assert(!sccroll_run());
+    assert(access(tracefile, F_OK) < 0);
+    return EXIT_SUCCESS;
+}
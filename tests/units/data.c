@@ -89,6 +89,90 @@ void tests_datas(void)
     free(data);
 }
 
+// BLAKE3 reference digests.
+#define emptyhash "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262"
+#define abchash "6437b3ac38465133ffb63b75273a8db548c558465d79db03fd359c6cd5bd9d85"
+// Digest of the 5000 first bytes of the sequence 0, 1, ..., 250, 0,
+// 1, ..., spanning multiple chunks.
+#define patternhash "ee78d92070de3df1c57c37002abf0a6b1a6589acdeef4d8ffac7cf3d9e8f2836"
+
+void tests_hash(void)
+{
+    char hex[SCCHASHHEX] = { 0 };
+    unsigned char pattern[5000] = { 0 };
+    SccrollHash hash;
+
+    assert(!strcmp(sccroll_hash(NULL, 0, hex), emptyhash));
+    assert(!strcmp(sccroll_hash("abc", 3, hex), abchash));
+
+    for (size_t i = 0; i < sizeof(pattern); ++i) pattern[i] = i % 251;
+    assert(!strcmp(sccroll_hash(pattern, sizeof(pattern), hex), patternhash));
+
+    // Streaming the blob in uneven parts gives the same digest.
+    sccroll_hashInit(&hash);
+    for (size_t i = 0, part = 1; i < sizeof(pattern); i += part, part = part * 3 % 1031)
+        sccroll_hashUpdate(&hash, pattern + i, part < sizeof(pattern) - i ? part : sizeof(pattern) - i);
+    assert(!strcmp(sccroll_hashFinal(&hash, hex), patternhash));
+
+    FILE* stream = tmpfile();
+    assert(stream && fwrite(pattern, sizeof(char), sizeof(pattern), stream) == sizeof(pattern));
+    rewind(stream);
+    assert(sccroll_hashFile(stream, hex) == sizeof(pattern));
+    assert(!strcmp(hex, patternhash));
+    fclose(stream);
+}
+
+// The spans must be found whatever the position of their end
+// relatively to the vectors boundaries.
+void tests_span(void)
+{
+    unsigned char a[300] = { 0 };
+    unsigned char b[300] = { 0 };
+
+    for (size_t size = 0; size < sizeof(a); ++size)
+        for (size_t end = 0; end <= size; ++end) {
+            for (size_t i = 0; i < size; ++i) a[i] = b[i] = i % 251;
+            if (end < size) b[end] ^= 0x80;
+            assert(blobspan(a, b, size, true) == end);
+
+            for (size_t i = 0; i < size; ++i) b[i] = ~a[i];
+            if (end < size) b[end] = a[end];
+            assert(blobspan(a, b, size, false) == end);
+        }
+}
+
+// The arena allocations must be aligned, distinct, and survive the
+// allocation of new chunks until the reset.
+void tests_arena(void)
+{
+    SccrollArena arena = { 0 };
+    char* blobs[SCCARENACHUNK/16] = { NULL };
+
+    for (size_t i = 0; i < sizeof(blobs)/sizeof(char*); ++i) {
+        blobs[i] = sccroll_arenaAlloc(&arena, 1 + i % 100);
+        assert(blobs[i] && !((uintptr_t)blobs[i] % SCCARENAALIGN));
+        memset(blobs[i], i % 251, 1 + i % 100);
+    }
+    assert(arena.head->next);
+    for (size_t i = 0; i < sizeof(blobs)/sizeof(char*); ++i)
+        for (size_t j = 0; j < 1 + i % 100; ++j) assert(blobs[i][j] == (char)(i % 251));
+
+    // Larger allocations get their own chunk.
+    assert(sccroll_arenaAlloc(&arena, SCCARENACHUNK * 2));
+    assert(arena.head->size == SCCARENACHUNK * 2);
+
+    char* copy = sccroll_arenaDup(&arena, "foobar", 3);
+    assert(copy && !strcmp(copy, "foo"));
+    copy = sccroll_arenaDup(&arena, NULL, 3);
+    assert(copy && !copy[0] && !copy[1] && !copy[2] && !copy[3]);
+
+    // Only the first chunk is kept after a reset.
+    sccroll_arenaReset(&arena);
+    assert(arena.head && !arena.head->next && !arena.head->used);
+    sccroll_arenaFree(&arena);
+    assert(!arena.head);
+}
+
 // clang-format off
 
 /******************************************************************************
@@ -140,5 +224,9 @@ int main(void)
     tests_datas();
     sccroll_mockPredefined(tests_datas);
 
+    tests_hash();
+    tests_span();
+    tests_arena();
+
     return EXIT_SUCCESS;
 }
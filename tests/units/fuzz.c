@@ -0,0 +1,246 @@
+/**
+ * @file        fuzz.c
+ * @version     0.1.0
+ * @brief       Fuzz module unit tests.
+ * @author      Alexandre Martos
+ * @email       contact@amartos.fr
+ * @copyright   2022-2023 Alexandre Martos <contact@amartos.fr>
+ * @license     MIT License
+ */
+
+#include "units.h"
+
+// clang-format off
+
+/******************************************************************************
+ * Preparation
+ ******************************************************************************/
+// clang-format on
+
+// Constants
+enum {
+    SEED = 42,     // Fixed seed for reproducible runs.
+    RUNS = 1000,   // Number of mutated inputs per fuzzing.
+    PERSIST = 100, // Number of inputs per persistent child.
+};
+
+// Template for the temporary directories.
+#define template "/tmp/sccroll.fuzz.XXXXXX"
+
+// The input crashing the parser.
+#define bugstr "bug!"
+
+static const char* dict[] = { "foo", bugstr, "bar", NULL };
+
+// Fake parser crashing on a given header. The byte by byte checks
+// provide a coverage gradient.
+void test_parser(void)
+{
+    char buffer[SCCMAX] = { 0 };
+    size_t size = fread(buffer, sizeof(char), SCCMAX, stdin);
+    if (size > 0 && buffer[0] == 'b')
+        if (size > 1 && buffer[1] == 'u')
+            if (size > 2 && buffer[2] == 'g')
+                if (size > 3 && buffer[3] == '!')
+                    raise(SIGSEGV);
+}
+
+// Fake parser which never crashes, but whose coverage depends on the
+// input length.
+void test_counter(void)
+{
+    int count = 0;
+    while (getchar() != EOF) ++count;
+    printf("%i\n", count);
+}
+
+static SccrollEffects parser = {
+    .wrapper = test_parser,
+    .name = "test parser",
+    .flags = NODIFF,
+};
+
+// Count the files of a directory.
+int count(const char* restrict path)
+{
+    int files = 0;
+    struct dirent* entry = NULL;
+    DIR* dir = opendir(path);
+    if (!dir) return 0;
+    while ((entry = readdir(dir))) files += entry->d_type == DT_REG;
+    closedir(dir);
+    return files;
+}
+
+// Give the path of the first file of a directory.
+void first(const char* restrict path, char* restrict file)
+{
+    struct dirent* entry = NULL;
+    DIR* dir = opendir(path);
+    assert(dir);
+    while ((entry = readdir(dir)) && entry->d_type != DT_REG);
+    assert(entry);
+    sprintf(file, "%s/%s", path, entry->d_name);
+    closedir(dir);
+}
+
+// Write an input file in a directory.
+void mkinput(const char* restrict dir, const char* restrict name, const char* restrict content)
+{
+    char path[SCCMAX] = { 0 };
+    sprintf(path, "%s/%s", dir, name);
+    FILE* stream = fopen(path, "w");
+    assert(stream && fputs(content, stream) >= 0);
+    fclose(stream);
+}
+
+// clang-format off
+
+/******************************************************************************
+ * Tests
+ ******************************************************************************/
+// clang-format on
+
+// Without mutations, only the given inputs are executed.
+void test_noruns(void)
+{
+    SccrollFuzz options = { 0 };
+    assert(!sccroll_fuzz(&parser, &options));
+}
+
+// Without any corpus nor dictionary, the corpus should grow with the
+// new coverage.
+void test_coverage(void)
+{
+    char corpus[] = template;
+    assert(mkdtemp(corpus));
+    SccrollEffects counter = { .wrapper = test_counter, .name = "test counter", .flags = NODIFF };
+    SccrollFuzz options = { .corpus = corpus, .runs = RUNS, .seed = SEED };
+    assert(!sccroll_fuzz(&counter, &options));
+    assert(count(corpus) > 1);
+    rmtree(corpus);
+}
+
+// The dictionary should lead to the crash, and the crashing input
+// should reproduce it in a regular test.
+void test_crash(void)
+{
+    char crashes[] = template;
+    char path[SCCMAX] = { 0 };
+    char buffer[SCCMAX] = { 0 };
+    assert(mkdtemp(crashes));
+    SccrollFuzz options = { .crashes = crashes, .dict = dict, .runs = RUNS, .seed = SEED };
+    assert(sccroll_fuzz(&parser, &options) == count(crashes));
+    assert(count(crashes) > 0);
+
+    first(crashes, path);
+    FILE* stream = fopen(path, "rb");
+    assert(stream && fread(buffer, sizeof(char), SCCMAX, stream) >= strlen(bugstr));
+    assert(!strncmp(buffer, bugstr, strlen(bugstr)));
+    fclose(stream);
+
+    SccrollEffects reproduce = {
+        .wrapper = test_parser,
+        .name = "test parser crash",
+        .std[STDIN_FILENO].path = path,
+        .code = { .type = SCCSIGNAL, .value = SIGSEGV },
+    };
+    sccroll_register(&reproduce);
+    assert(!sccroll_run());
+
+    // Crashing inputs are saved only once.
+    assert(!sccroll_fuzz(&parser, &options));
+
+    // Without a crashes directory, the distinct crashing inputs are
+    // still counted only once.
+    options.crashes = NULL;
+    assert(sccroll_fuzz(&parser, &options) == count(crashes));
+    rmtree(crashes);
+}
+
+// The persistent mode should reach the same coverage and crashes,
+// with a fresh standard input for each iteration.
+void test_persistent(void)
+{
+    char corpus[] = template;
+    char crashes[] = template;
+    assert(mkdtemp(corpus) && mkdtemp(crashes));
+    SccrollEffects counter = { .wrapper = test_counter, .name = "test counter", .flags = NODIFF };
+    SccrollFuzz options = { .corpus = corpus, .runs = RUNS, .seed = SEED, .persist = PERSIST };
+    assert(!sccroll_fuzz(&counter, &options));
+    assert(count(corpus) > 1);
+
+    options = (SccrollFuzz){ .crashes = crashes, .dict = dict, .runs = RUNS, .seed = SEED, .persist = PERSIST };
+    assert(sccroll_fuzz(&parser, &options) == count(crashes));
+    assert(count(crashes) > 0);
+    rmtree(corpus);
+    rmtree(crashes);
+}
+
+// The minimized corpus should drop the duplicates, the inputs
+// reaching no new coverage, and the crashing ones.
+void test_minimize(void)
+{
+    char corpus[] = template;
+    char output[] = template;
+    char again[] = template;
+    assert(mkdtemp(corpus) && mkdtemp(output) && mkdtemp(again));
+    SccrollEffects counter = { .wrapper = test_counter, .name = "test counter", .flags = NODIFF };
+    SccrollFuzz options = { .corpus = corpus };
+    int kept = 0;
+
+    // Duplicates are executed and kept only once.
+    mkinput(corpus, "original", "aa");
+    mkinput(corpus, "duplicate", "aa");
+    assert(sccroll_minimize(&counter, &options, output) == 1);
+    rmtree(output);
+
+    // The longest inputs fall in the same counter loop hit count
+    // classes, and the minimized corpus is already minimal.
+    const char* inputs[] = { "", "a", "aaa", "aaaa", "aaaaa", "aaaaaa", NULL };
+    char name[] = "0";
+    for (int i = 0; inputs[i]; ++i, ++*name) mkinput(corpus, name, inputs[i]);
+    assert(mkdtemp(strcpy(output, template)));
+    kept = sccroll_minimize(&counter, &options, output);
+    assert(kept > 1 && kept < 7 && kept == count(output));
+    options.corpus = output;
+    assert(sccroll_minimize(&counter, &options, again) == kept);
+    rmtree(corpus);
+    rmtree(output);
+    rmtree(again);
+
+    // Crashing inputs are dropped, and the too long inputs are
+    // skipped even if they reach new coverage.
+    char* longer = memset(calloc(SCCMAXINPUT + 2, sizeof(char)), 'u', SCCMAXINPUT + 1);
+    assert(longer && (*longer = 'b'));
+    assert(mkdtemp(strcpy(corpus, template)) && mkdtemp(strcpy(output, template)));
+    mkinput(corpus, "crash", bugstr);
+    mkinput(corpus, "safe", "b");
+    mkinput(corpus, "longer", longer);
+    free(longer);
+    options = (SccrollFuzz){ .corpus = corpus, .persist = PERSIST };
+    assert(sccroll_minimize(&parser, &options, output) == 1);
+    rmtree(corpus);
+    rmtree(output);
+
+    // Missing corpora are empty.
+    options.corpus = template;
+    assert(!sccroll_minimize(&parser, &options, output));
+}
+
+// clang-format off
+
+/******************************************************************************
+ * Execution
+ ******************************************************************************/
+// clang-format on
+
+int main(void)
+{
+    test_noruns();
+    test_coverage();
+    test_crash();
+    test_persistent();
+    test_minimize();
+    return EXIT_SUCCESS;
+}
@@ -401,6 +401,58 @@ void test_mockPredefined(void)
     sccroll_mockPredefined(test_fullerrors);
 }
 
+// Give the nanoseconds elapsed between two times.
+long long elapsed(const struct timespec* start, const struct timespec* end)
+{
+    return (end->tv_sec - start->tv_sec) * 1000000000LL + end->tv_nsec - start->tv_nsec;
+}
+
+void test_clock(void)
+{
+    enum { HOUR = 3600, SECOND = 1000000000 };
+    struct timespec start = { 0 }, now = { 0 }, cpu = { 0 };
+    struct timeval before = { 0 }, after = { 0 }, timeout = { .tv_sec = HOUR };
+    int fds[2] = { 0 };
+    fd_set set;
+    time_t then = 0;
+
+    assert(!pipe(fds));
+    sccroll_mockClock(true);
+    assert(!clock_gettime(CLOCK_MONOTONIC, &start) && !gettimeofday(&before, NULL));
+    then = time(NULL);
+
+    // The sleeps and timeouts return at once, advancing the clock.
+    assert(!sleep(HOUR) && !usleep(1000000));
+    assert(!nanosleep(&(struct timespec){ .tv_nsec = 500 }, &now) && !now.tv_nsec);
+    assert(!poll(&(struct pollfd){ .fd = fds[0], .events = POLLIN }, 1, 60000));
+    FD_ZERO(&set);
+    FD_SET(fds[0], &set);
+    assert(!select(fds[0] + 1, &set, NULL, NULL, &timeout) && !timeout.tv_sec);
+    sccroll_mockAdvance(500);
+    assert(!clock_gettime(CLOCK_MONOTONIC, &now));
+    assert(elapsed(&start, &now) == (2LL * HOUR + 61) * SECOND + 1000);
+    assert(time(NULL) - then >= 2 * HOUR + 61 && time(NULL) - then <= 2 * HOUR + 62);
+    assert(!gettimeofday(&after, NULL) && after.tv_sec - before.tv_sec >= 2 * HOUR + 61);
+
+    // The absolute sleeps only advance up to their deadline.
+    now.tv_sec += 1;
+    assert(!clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &now, NULL));
+    assert(!clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &start, NULL));
+    assert(!clock_gettime(CLOCK_MONOTONIC, &start) && !elapsed(&now, &start));
+
+    // The ready descriptors are not waited for.
+    assert(write(fds[1], "x", 1) == 1);
+    assert(poll(&(struct pollfd){ .fd = fds[0], .events = POLLIN }, 1, 60000) == 1);
+    assert(!clock_gettime(CLOCK_MONOTONIC, &now) && !elapsed(&start, &now));
+
+    // The CPU time is never virtual.
+    assert(!clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu) && cpu.tv_sec < HOUR);
+
+    sccroll_mockClock(false);
+    assert(!clock_gettime(CLOCK_MONOTONIC, &now) && now.tv_sec < start.tv_sec - HOUR);
+    close(fds[0]), close(fds[1]);
+}
+
 // clang-format off
 
 /******************************************************************************
@@ -416,6 +468,7 @@ int main(void)
     int status = sccroll_simplefork("test_abort_atexit", test_abort_atexit);
     assert(WTERMSIG(status) == SIGABRT);
     test_flush();
+    test_clock();
     for (delay = 0; delay < MAX; ++delay) {
         status = sccroll_simplefork("test delay", test_delay);
         assert(WTERMSIG(status) == SIGABRT);
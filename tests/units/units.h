@@ -0,0 +1,64 @@
+/**
+ * @file        units.h
+ * @version     0.1.0
+ * @brief       Helpers shared by the units tests.
+ * @author      Alexandre Martos
+ * @email       contact@amartos.fr
+ * @copyright   2022-2023 Alexandre Martos <contact@amartos.fr>
+ * @license     MIT License
+ */
+
+#ifndef SCCROLL_UNITS_H_
+#define SCCROLL_UNITS_H_
+
+#include <assert.h>
+
+#include "sccroll.h"
+
+#include <ftw.h>
+
+// Check the content of a file.
+static inline void checkfile(const char* restrict path, const char* restrict content)
+{
+    char buffer[SCCMAX] = { 0 };
+    FILE* stream = fopen(path, "r");
+    assert(stream && fread(buffer, sizeof(char), SCCMAX, stream) == strlen(content));
+    assert(!strcmp(buffer, content));
+    fclose(stream);
+}
+
+// Check that a file contains a string, or not.
+static inline void checkfind(const char* restrict path, const char* restrict content, bool present)
+{
+    char buffer[SCCMAX] = { 0 };
+    FILE* stream = fopen(path, "r");
+    assert(stream && fread(buffer, sizeof(char), SCCMAX - 1, stream) > 0);
+    assert(!strstr(buffer, content) == !present);
+    fclose(stream);
+}
+
+// Run the registered tests with stderr redirected to a file, and
+// check the number of failed tests.
+static inline void runto(const char* restrict path, int failed)
+{
+    int saved = dup(STDERR_FILENO);
+    assert(saved >= 0 && freopen(path, "w", stderr));
+    assert(sccroll_run() == failed);
+    fflush(stderr);
+    assert(dup2(saved, STDERR_FILENO) == STDERR_FILENO && !close(saved));
+}
+
+static inline int rmfile(const char* path, const struct stat* sb, int flag, struct FTW* ftw)
+{
+    sccroll_unused(sb), sccroll_unused(flag), sccroll_unused(ftw);
+    return remove(path);
+}
+
+// Remove a files tree, if it exists.
+static inline void rmtree(const char* restrict path)
+{
+    if (nftw(path, rmfile, 16, FTW_DEPTH | FTW_PHYS) < 0 && errno != ENOENT)
+        err(EXIT_FAILURE, "could not remove %s", path);
+}
+
+#endif // SCCROLL_UNITS_H_